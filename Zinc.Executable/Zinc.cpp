@@ -1,14 +1,234 @@
 #include "../Zinc/Zinc.hpp"
 
 #include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 using namespace Zinc;
 
-int main()
+class MappedFile
+{
+public:
+	MappedFile()
+		: m_data(nullptr),
+		m_size(0)
+#ifdef _WIN32
+		, m_file(INVALID_HANDLE_VALUE),
+		m_mapping(nullptr)
+#else
+		, m_file(-1)
+#endif
+	{
+	}
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile & operator=(const MappedFile &) = delete;
+
+	~MappedFile()
+	{
+#ifdef _WIN32
+		if (m_data) UnmapViewOfFile(m_data);
+		if (m_mapping) CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+		if (m_data) munmap(m_data, m_size);
+		if (m_file >= 0) close(m_file);
+#endif
+	}
+
+	bool Open(const char * path)
+	{
+#ifdef _WIN32
+		m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_file, &size)) return false;
+		m_size = (size_t)size.QuadPart;
+		if (m_size == 0) return true;
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mapping) return false;
+		m_data = static_cast<char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		return m_data != nullptr;
+#else
+		m_file = open(path, O_RDONLY);
+		if (m_file < 0) return false;
+		struct stat info;
+		if (fstat(m_file, &info) != 0) return false;
+		m_size = (size_t)info.st_size;
+		if (m_size == 0) return true;
+		void * data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_file, 0);
+		if (data == MAP_FAILED) return false;
+		m_data = static_cast<char *>(data);
+		madvise(m_data, m_size, MADV_SEQUENTIAL);
+		return true;
+#endif
+	}
+
+	bool Create(const char * path, size_t size)
+	{
+		m_size = size;
+#ifdef _WIN32
+		m_file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE) return false;
+		if (m_size == 0) return true;
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, (DWORD)((unsigned long long)m_size >> 32), (DWORD)m_size, nullptr);
+		if (!m_mapping) return false;
+		m_data = static_cast<char *>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, 0));
+		return m_data != nullptr;
+#else
+		m_file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (m_file < 0) return false;
+		if (ftruncate(m_file, (off_t)m_size) != 0) return false;
+		if (m_size == 0) return true;
+		void * data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+		if (data == MAP_FAILED) return false;
+		m_data = static_cast<char *>(data);
+		return true;
+#endif
+	}
+
+	char * Data() const
+	{
+		return m_data;
+	}
+
+	size_t Size() const
+	{
+		return m_size;
+	}
+
+private:
+	char * m_data;
+	size_t m_size;
+#ifdef _WIN32
+	HANDLE m_file;
+	HANDLE m_mapping;
+#else
+	int m_file;
+#endif
+};
+
+template <class T, typename V>
+static int EvaluateBinary(const Expression<T> & expr, const char * input, const char * output)
+{
+	MappedFile in;
+	if (!in.Open(input)) return -1;
+	size_t count = in.Size() / sizeof(V);
+	MappedFile out;
+	if (!out.Create(output, count * sizeof(V))) return -1;
+	parallel_evaluate(expr, _x, reinterpret_cast<const V *>(in.Data()), reinterpret_cast<V *>(out.Data()), count);
+	return 0;
+}
+
+template <class F>
+static size_t ForEachColumnValue(const char * begin, const char * end, const F & f)
+{
+	size_t count = 0;
+	const char * line = begin;
+	while (line < end)
+	{
+		const char * next = static_cast<const char *>(std::memchr(line, '\n', end - line));
+		if (!next) next = end;
+		while (line < next && (*line == ' ' || *line == '\t')) ++line;
+		if (line < next && *line != '#' && *line != '\r')
+		{
+			char token[64];
+			size_t length = 0;
+			while (line + length < next && length + 1 < sizeof(token) && line[length] != ' ' && line[length] != '\t' && line[length] != ',' && line[length] != '\r')
+			{
+				token[length] = line[length];
+				++length;
+			}
+			token[length] = 0;
+			f(count++, std::strtod(token, nullptr));
+		}
+		line = next + 1;
+	}
+	return count;
+}
+
+template <class T>
+static int EvaluateText(const Expression<T> & expr, const char * input, const char * output)
+{
+	MappedFile in;
+	if (!in.Open(input)) return -1;
+	const char * begin = in.Data();
+	const char * end = begin + in.Size();
+	size_t count = ForEachColumnValue(begin, end, [](size_t, double) {});
+	MappedFile out;
+	if (!out.Create(output, count * sizeof(double))) return -1;
+	double * values = reinterpret_cast<double *>(out.Data());
+	ForEachColumnValue(begin, end, [&](size_t i, double value) { values[i] = value; });
+	parallel_evaluate(expr, _x, values, values, count);
+	return 0;
+}
+
+template <class T>
+static int WriteImage(const Expression<T> & expr, const char * output)
+{
+	std::vector<char> buffer;
+	serialize(expr, buffer);
+	MappedFile out;
+	if (!out.Create(output, buffer.size())) return -1;
+	std::memcpy(out.Data(), buffer.data(), buffer.size());
+	return 0;
+}
+
+static int EvaluateImage(const char * path, const char * input, const char * output)
+{
+	MappedFile file;
+	ExpressionImage image;
+	if (!file.Open(path) || !image.Load(file.Data(), file.Size())) return -1;
+	MappedFile in;
+	if (!in.Open(input)) return -1;
+	size_t count = in.Size() / sizeof(double);
+	MappedFile out;
+	if (!out.Create(output, count * sizeof(double))) return -1;
+	const double * values = reinterpret_cast<const double *>(in.Data());
+	double * results = reinterpret_cast<double *>(out.Data());
+	std::vector<long double> scratch(image.Size());
+	DynamicEnvironment env;
+	for (size_t i = 0; i < count; ++i)
+	{
+		env.Set(_x, values[i]);
+		results[i] = (double)image(env, scratch.data());
+	}
+	return 0;
+}
+
+int main(int argc, char ** argv)
 {
 	auto expr =
 		#include "expression"
 		;
+
+	if (argc >= 5 && std::strcmp(argv[1], "--load") == 0) return EvaluateImage(argv[2], argv[3], argv[4]);
+	if (argc >= 3 && std::strcmp(argv[1], "--image") == 0) return WriteImage(expr, argv[2]);
+
+	if (argc >= 3)
+	{
+		const char * format = argc >= 4 ? argv[3] : "f64";
+		if (std::strcmp(format, "f64") == 0) return EvaluateBinary<decltype(expr), double>(expr, argv[1], argv[2]);
+		// f80 records are x87 extended values in long double slots of 10 or 16 bytes. Where long double
+		// is only a double (MSVC) or another format, the input cannot be read and is rejected.
+		if (std::strcmp(format, "f80") == 0)
+		{
+			if ((sizeof(long double) != 10 && sizeof(long double) != 16) || std::numeric_limits<long double>::digits != 64) return -1;
+			return EvaluateBinary<decltype(expr), long double>(expr, argv[1], argv[2]);
+		}
+		if (std::strcmp(format, "text") == 0) return EvaluateText(expr, argv[1], argv[2]);
+		return -1;
+	}
+
 	auto limit = lim(_x.to(
 		#include "limit"
 		), expr);
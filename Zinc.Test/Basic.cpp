@@ -444,6 +444,748 @@ namespace Zinc { namespace Tests {
 			auto limit = lim(_x.to<0>(), expr);
 			Assert::IsTrue(limit == 1);
 		}
+
+		ZN_TEST_METHOD(StageTest1)
+		{
+			auto expr = sin(_pi / 2) * 3 + _x;
+			auto staged = stage(expr);
+			bool same = std::is_same<decltype(staged), BinarryExpression<Addition, Numeric<long double>, Variable<'x'> > >::value;
+			Assert::IsTrue(same);
+		}
+
+		ZN_TEST_METHOD(StageTest2)
+		{
+			auto expr = power<2>(_x) * (cos(_pi) - 1) / (2 + _x);
+			auto staged = stage(expr);
+			auto bind1 = bind(expr, _x, 3);
+			auto bind2 = bind(staged, _x, 3);
+			long double expected = bind1();
+			long double actual = bind2();
+			Assert::IsTrue(expected == actual);
+		}
+
+
+		ZN_TEST_METHOD(IncrementalTest1)
+		{
+			auto expr = _k * sin(_x) + power<2>(_y);
+			auto inc = incremental(expr);
+			inc.set(_x, 2).set(_y, 3).set(_k, 1);
+			long double expected = bind(bind(bind(expr, _x, 2), _y, 3), _k, 5)();
+			inc.set(_k, 5);
+			long double actual = inc();
+			Assert::IsTrue(expected == actual);
+		}
+
+		ZN_TEST_METHOD(IncrementalTest2)
+		{
+			auto expr = _x / _y;
+			auto inc = incremental(expr);
+			inc.set(_x, 1);
+			Assert::IsTrue(inc() != inc());
+			inc.set('y', 4);
+			Assert::IsTrue(inc() == 0.25);
+		}
+
+
+		ZN_TEST_METHOD(AnyExpressionTest1)
+		{
+			std::vector<AnyExpression> exprs;
+			exprs.push_back(_x + 1);
+			exprs.push_back(sin(_x) * _k);
+			exprs.push_back(Numeric<int>(3) / 2);
+			auto bound = bind(exprs[1], _x, 0);
+			Assert::IsTrue(exprs[0].bind('x', 2)() == 3);
+			Assert::IsTrue(bind(bound, _k, 2)() == 0);
+			Assert::IsTrue(exprs[2]() == 1.5);
+			Assert::IsTrue((std::string)exprs[1] == "(sin(x)*k)");
+		}
+
+		ZN_TEST_METHOD(AnyExpressionTest2)
+		{
+			AnyExpression expr = (_x + 1) * (_x + 2);
+			auto sum = expr + _y;
+			auto rez = bind(bind(sum, _x, 1), _y, 4);
+			Assert::IsTrue(rez() == 10);
+			Assert::IsTrue(sizeof(AnyExpression) <= AnyExpression::capacity + 2 * sizeof(void *));
+			Assert::IsTrue(std::is_nothrow_move_constructible<AnyExpression>::value && std::is_nothrow_move_assignable<AnyExpression>::value);
+		}
+
+		ZN_TEST_METHOD(AnyExpressionTest3)
+		{
+			AnyExpression any = _x * 2;
+			Assert::IsTrue(std::abs(bind(stage(any + 1), _x, 0.3L)() - 1.6L) < 1e-15);
+			Assert::IsTrue(std::abs(evaluate(any, Environment<VariableList<'x'> >().Set(_x, 0.3L)) - 0.6L) < 1e-15);
+			Assert::IsTrue(std::abs(evaluate(any.bind('x', 0.3L) * _y, DynamicEnvironment().Set(_y, 2)) - 1.2L) < 1e-15);
+			auto inc = incremental(any + _y);
+			inc.set(_y, 1).set(_x, 2);
+			Assert::IsTrue(inc() == 5);
+			double xs[] = { 1, 2 };
+			double ys[] = { 3, 4, 5 };
+			long double actual[2 * 3];
+			evaluate_grid(any + _y, actual, _x.over(xs, 2), _y.over(ys, 3));
+			Assert::IsTrue(actual[0] == 5 && actual[5] == 9);
+		}
+
+
+		ZN_TEST_METHOD(ArenaTest1)
+		{
+			Arena arena;
+			auto expr = build(_x / sin(_y), arena);
+			auto derived = derive(expr);
+			std::string expected = "(((1*sin(y))-(x*(cos(y)*1)))/((sin(y))^2))";
+			std::string actual = derived;
+			Assert::IsTrue(expected == actual);
+		}
+
+		ZN_TEST_METHOD(ArenaTest2)
+		{
+			Arena arena(256);
+			for (int i = 0; i < 1000; ++i)
+			{
+				arena.Release();
+				auto expr = build(power<3>(_x) + _k * _x, arena);
+				auto rez = bind(bind(derive(expr), _x, 2), _k, i);
+				Assert::IsTrue(rez() == 14 + i);
+			}
+		}
+
+		ZN_TEST_METHOD(ArenaTest3)
+		{
+			Arena arena;
+			auto derived = build(sin(_x) * _x, arena);
+			for (int i = 0; i < 24; ++i) derived = derive(derived);
+			DynamicEnvironment env;
+			env.Set(_x, 0.5L);
+			long double expected = 0.5L * Sinus()(0.5L) - 24 * Cosinus()(0.5L);
+			Assert::IsTrue(std::abs(evaluate_many(env, derived)[0] - expected) < 1e-12);
+		}
+
+
+		ZN_TEST_METHOD(ParallelEvaluateTest1)
+		{
+			auto expr = sin(_x) * _x + power<2>(_x) / (1 + _x);
+			std::vector<double> inputs(100003);
+			for (size_t i = 0; i < inputs.size(); ++i) inputs[i] = i * 0.001;
+			std::vector<double> expected(inputs.size());
+			parallel_evaluate(expr, _x, inputs.data(), expected.data(), expected.size(), 1);
+			Assert::IsTrue(std::abs(expected[1234] - (double)bind(expr, _x, inputs[1234])()) < 1e-9);
+			for (unsigned threads : { 3u, 8u })
+			{
+				std::vector<double> actual(inputs.size());
+				parallel_evaluate(expr, _x, inputs.data(), actual.data(), actual.size(), threads);
+				Assert::IsTrue(expected == actual);
+			}
+		}
+
+
+		ZN_TEST_METHOD(SampleTest1)
+		{
+			auto expr = power<2>(_x) + 1;
+			std::vector<std::pair<long double, long double> > points;
+			auto count = sample(expr, _x, -1, 1, 1e-3, [&](long double x, long double y) { points.emplace_back(x, y); });
+			Assert::IsTrue(points.front().first == -1 && points.back().first == 1);
+			for (size_t i = 1; i < points.size(); ++i) Assert::IsTrue(points[i - 1].first < points[i].first);
+			for (auto & point : points) Assert::IsTrue(std::abs(point.second - (point.first * point.first + 1)) < 1e-12);
+			Assert::IsTrue(count == points.size());
+			Assert::IsTrue(count < 200);
+		}
+
+		ZN_TEST_METHOD(SampleTest2)
+		{
+			auto expr = _x / sin(_x);
+			size_t nearPole = 0;
+			size_t flat = 0;
+			sample(expr, _x, 0.1, 3, 1e-2, [&](long double x, long double) { if (x > 2.9) ++nearPole; else if (x < 0.5) ++flat; });
+			Assert::IsTrue(nearPole > flat);
+		}
+
+		ZN_TEST_METHOD(SampleTest3)
+		{
+			size_t undefined = 0;
+			size_t defined = 0;
+			auto count = sample(sqrt(_x), _x, -1, 1, 1e-3, [&](long double, long double y) { if (std::isfinite(y)) ++defined; else ++undefined; });
+			Assert::IsTrue(count == undefined + defined);
+			Assert::IsTrue(defined > 0 && undefined < 64);
+			Assert::IsTrue(count < 200);
+		}
+
+
+		ZN_TEST_METHOD(GridTest1)
+		{
+			auto expr = sin(_x) * power<2>(_y) + cos(_pi) * _x / (1 + _y);
+			std::vector<double> xs(70), ys(45);
+			for (size_t i = 0; i < xs.size(); ++i) xs[i] = i * 0.05;
+			for (size_t j = 0; j < ys.size(); ++j) ys[j] = j * 0.1 - 2.05;
+			std::vector<long double> actual(xs.size() * ys.size());
+			evaluate_grid(expr, actual.data(), _x.over(xs.data(), xs.size()), _y.over(ys.data(), ys.size()));
+			for (size_t i = 0; i < xs.size(); ++i)
+			{
+				for (size_t j = 0; j < ys.size(); ++j)
+				{
+					long double expected = bind(bind(expr, _x, (long double)xs[i]), _y, (long double)ys[j])();
+					Assert::IsTrue(std::abs(actual[i * ys.size() + j] - expected) < 1e-12);
+				}
+			}
+		}
+
+		ZN_TEST_METHOD(GridTest2)
+		{
+			auto expr = _x * 100 + _z - _y * 10;
+			double xs[] = { 1, 2, 3 };
+			double ys[] = { 4, 5 };
+			double zs[] = { 6, 7, 8, 9 };
+			double actual[3 * 2 * 4];
+			evaluate_grid(expr, actual, _x.over(xs, 3), _y.over(ys, 2), _z.over(zs, 4));
+			Assert::IsTrue(actual[0] == 66 && actual[23] == 259 && actual[1 * 8 + 1 * 4 + 2] == 158);
+		}
+
+
+		ZN_TEST_METHOD(IntegrateTest1)
+		{
+			auto expr = power<3>(_x) - 2 * _x + 1;
+			long double actual = integrate(expr, _x, 0, 2);
+			Assert::IsTrue(std::abs(actual - 2) < 1e-12);
+		}
+
+		ZN_TEST_METHOD(IntegrateTest2)
+		{
+			auto expr = 1 / (1 + power<2>(_x));
+			long double expected = 2.4980915447965089146L;
+			Assert::IsTrue(std::abs(integrate(expr, _x, -3, 3, 1e-12L) - expected) < 1e-10);
+			Assert::IsTrue(std::abs(integrate(expr, _x, -3, 3, 1e-12L, Quadrature::TanhSinh) - expected) < 1e-10);
+		}
+
+		ZN_TEST_METHOD(IntegrateTest3)
+		{
+			auto expr = 1 / power<2>(_x - 1);
+			auto singular = _x / _x;
+			Assert::IsTrue(std::abs(integrate(singular, _x, 0, 1, 1e-12L, Quadrature::TanhSinh) - 1) < 1e-10);
+			Assert::IsTrue(std::abs(integrate(expr, _x, 2, 3) - 0.5L) < 1e-10);
+			Assert::IsTrue(std::abs(integrate(1 / sqrt(_x), _x, 0, 1, 1e-10L, Quadrature::TanhSinh) - 2) < 1e-8);
+			Assert::IsTrue(!std::isfinite(integrate(1 / (_x - 0.5L), _x, 0, 1, 1e-10L, Quadrature::TanhSinh)));
+		}
+
+
+		ZN_TEST_METHOD(FindRootsTest1)
+		{
+			auto expr = power<2>(_x) - 2;
+			auto roots = find_roots(expr, _x, { 1, -3, 10, 0.5 });
+			long double root = 1.41421356237309504880L;
+			Assert::IsTrue(std::abs(roots[0] - root) < 1e-12);
+			Assert::IsTrue(std::abs(roots[1] + root) < 1e-12);
+			Assert::IsTrue(std::abs(roots[2] - root) < 1e-12);
+			Assert::IsTrue(std::abs(roots[3] - root) < 1e-12);
+		}
+
+		ZN_TEST_METHOD(FindRootsTest2)
+		{
+			auto expr = power<3>(_x) - 2 * _x + 2;
+			auto roots = find_roots(expr, _x, { 0, -3 });
+			long double root = -1.76929235423863141524L;
+			Assert::IsTrue(std::abs(roots[1] - root) < 1e-12);
+			Assert::IsTrue(std::abs(roots[0] - root) < 1e-12);
+			auto flat = find_roots(power<3>(_x) + 1, _x, { 0 });
+			Assert::IsTrue(std::abs(flat[0] + 1) < 1e-12);
+		}
+
+
+		ZN_TEST_METHOD(TaylorSurrogateTest1)
+		{
+			auto expr = power<3>(_x) - 2 * _x / (1 + _x);
+			auto surrogate = taylor_surrogate<12>(expr, _x, 0.5);
+			Assert::IsTrue(surrogate.m_coefficients[0] == bind(expr, _x, 0.5L)());
+			for (long double x = 0.3L; x < 0.7L; x += 0.05L)
+			{
+				Assert::IsTrue(std::abs(surrogate(x) - bind(expr, _x, x)()) < 1e-6);
+			}
+		}
+
+		ZN_TEST_METHOD(TaylorSurrogateTest2)
+		{
+			auto expr = sin(_x) * cos(2 * _x);
+			auto surrogate = taylor_surrogate<4>(expr, _x, 0);
+			Assert::IsTrue(std::abs(surrogate.m_coefficients[1] - 1) < 1e-15);
+			Assert::IsTrue(std::abs(surrogate.m_coefficients[3] + 13.0L / 6) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(TaylorSurrogateTest3)
+		{
+			auto root = taylor_surrogate<6>(sqrt(_x + 1), _x, 0.0L);
+			Assert::IsTrue(root.m_coefficients[1] == 0.5L && root.m_coefficients[2] == -0.125L);
+			auto cube = taylor_surrogate<6>(power(_x + 1, 3), _x, 0.0L);
+			Assert::IsTrue(cube.m_coefficients[2] == 3 && cube.m_coefficients[3] == 1 && cube.m_coefficients[4] == 0);
+			auto expr = pow(_x + 1, _x) + log(_x + 2);
+			auto surrogate = taylor_surrogate<12>(expr, _x, 0.5L);
+			for (long double x = 0.4L; x < 0.6L; x += 0.05L)
+			{
+				Assert::IsTrue(std::abs(surrogate(x) - bind(expr, _x, x)()) < 1e-12);
+			}
+			Assert::IsTrue(std::string(power(_x, 3)()) == "(x^3)");
+		}
+
+
+		ZN_TEST_METHOD(ChebyshevFitTest1)
+		{
+			auto expr = 1 / (2 + power<2>(_x)) + _x;
+			auto fit = chebyshev_fit(expr, _x, -1, 3, 1e-12L);
+			Assert::IsTrue(fit.m_error < 1e-10);
+			Assert::IsTrue(fit.m_coefficients.size() < 128);
+			for (long double x = -1; x <= 3; x += 0.01L)
+			{
+				Assert::IsTrue(std::abs(fit(x) - bind(expr, _x, x)()) < 1e-10);
+			}
+		}
+
+		ZN_TEST_METHOD(ChebyshevFitTest2)
+		{
+			auto expr = power<3>(_x) - _x;
+			auto fit = chebyshev_fit(expr, _x, 0, 2);
+			double xs[] = { 0, 0.5, 1, 2 };
+			double ys[4];
+			fit(xs, ys, 4);
+			Assert::IsTrue(fit.m_coefficients.size() == 4);
+			Assert::IsTrue(std::abs(ys[1] + 0.375) < 1e-12 && std::abs(ys[3] - 6) < 1e-12);
+		}
+
+		ZN_TEST_METHOD(ChebyshevFitTest3)
+		{
+			auto expr = 1e-9L / (2 + power<2>(_x));
+			auto fit = chebyshev_fit(expr, _x, -1, 3, 1e-12L);
+			Assert::IsTrue(fit.m_coefficients.size() > 16);
+			Assert::IsTrue(fit.m_error < 1e-19);
+			for (long double x = -1; x <= 3; x += 0.01L)
+			{
+				Assert::IsTrue(std::abs(fit(x) - bind(expr, _x, x)()) < 1e-19);
+			}
+		}
+
+		ZN_TEST_METHOD(PrecisionTest1)
+		{
+			auto expr = (power<2>(_x) + 1) / (_x + 2) + sin(_x);
+			Environment<VariableList<'x'>, double> env;
+			env.Set(_x, 0.5);
+			auto value = evaluate(expr, env);
+			bool same = std::is_same<decltype(value), double>::value;
+			Assert::IsTrue(same);
+			Assert::IsTrue(std::abs(value - (long double)bind(expr, _x, 0.5L)()) < 1e-12);
+		}
+
+		ZN_TEST_METHOD(PrecisionTest2)
+		{
+			auto expr = (power<2>(_x) - 1) / (_x - 1);
+			auto limit = lim<double>(_x.to(1), expr);
+			bool same = std::is_same<decltype(limit), double>::value;
+			Assert::IsTrue(same);
+			Assert::IsTrue(limit == 2.0);
+			same = std::is_same<decltype(Div<float, int, true>::Get(1.0f, 2)), float>::value;
+			Assert::IsTrue(same);
+			Assert::IsTrue(Div<int, int, true>::Get(1, 2) == 0.5L);
+		}
+
+		ZN_TEST_METHOD(BindViewTest1)
+		{
+			auto expr = (power<3>(_x) + 2 * _x * _y) / (_y - 4) + sin(_x);
+			auto view = bind_view(expr, _x, 0.5L);
+			auto bound = bind(view, _y, 2);
+			Assert::IsTrue(&bound.m_expr == &expr);
+			Assert::IsTrue(std::abs(bound() - bind(bind(expr, _x, 0.5L), _y, 2)()) < 1e-15);
+			Assert::IsTrue(std::abs(view.bind(_y, 3)() - bind(bind(expr, _x, 0.5L), _y, 3)()) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(BindViewTest2)
+		{
+			BinarryExpression<Addition, Numeric<std::string>, Variable<'x'> > expr(std::string(1000, 'a'), _x);
+			auto moved = std::move(expr);
+			Assert::IsTrue(expr.m_leftOperand.m_value.empty());
+			Assert::IsTrue(moved.m_leftOperand.m_value.size() == 1000);
+			bool nothrow = std::is_nothrow_move_constructible<decltype(moved)>::value;
+			Assert::IsTrue(nothrow);
+		}
+
+		ZN_TEST_METHOD(PowerTest5)
+		{
+			auto expr = power<64>(_x) + power(_x, 13) - power(_x, -3);
+			auto actual = bind(expr, _x, 1.01L)();
+			long double expected = 0;
+			long double x = 1;
+			for (int i = 1; i <= 64; ++i)
+			{
+				x *= 1.01L;
+				if (i == 64) expected += x;
+				if (i == 13) expected += x;
+				if (i == 3) expected -= 1 / x;
+			}
+			Assert::IsTrue(std::abs(actual - expected) / expected < 1e-15);
+			Assert::IsTrue(power<10>(2)() == 1024 && power(3, 5)() == 243);
+			auto derived = bind(derive(power(_x, 4)), _x, 2)();
+			Assert::IsTrue(std::abs(derived - 32) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(PowerTest6)
+		{
+			auto expr = pow(_x, _y) + sqrt(_x) + log(_y);
+			auto value = bind(bind(expr, _x, 4), _y, 2.5L)();
+			Assert::IsTrue(std::abs(value - (std::pow(4.0L, 2.5L) + 2 + std::log(2.5L))) < 1e-15);
+			auto derived = bind(derive(pow(_x, 3.0L) + sqrt(_x)), _x, 4)();
+			Assert::IsTrue(std::abs(derived - (48 + 0.25L)) < 1e-15);
+			Arena arena;
+			auto dynamic = build(expr, arena);
+			DynamicEnvironment env;
+			env.Set(_x, 4).Set(_y, 2.5L);
+			Assert::IsTrue(std::abs(dynamic(env) - value) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(PowerTest7)
+		{
+			auto derived = derive(pow(_x, 3.0L));
+			Assert::IsTrue(std::abs(bind(derived, _x, -2)() - 12) < 1e-15);
+			Assert::IsTrue(std::string(derived).find("log") == std::string::npos);
+			Arena arena;
+			DynamicEnvironment env;
+			env.Set(_x, -2);
+			Assert::IsTrue(std::abs(derive(build(pow(_x, 3.0L), arena))(env) - 12) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(StructuralHashTest1)
+		{
+			auto lhs = (power<2>(_x) + 3) / sin(_x * 2);
+			auto rhs = (power<2>(_x) + 3) / sin(_x * 2);
+			auto other = (power<2>(_x) + 4) / sin(_x * 2);
+			Assert::IsTrue(structural_hash(lhs) == structural_hash(rhs));
+			Assert::IsTrue(structural_equal(lhs, rhs));
+			Assert::IsTrue(structural_hash(lhs) != structural_hash(other));
+			Assert::IsTrue(!structural_equal(lhs, other));
+			Assert::IsTrue(!structural_equal(_x + 1, _x - 1));
+			Arena arena;
+			Assert::IsTrue(structural_hash(build(lhs, arena)) == structural_hash(build(rhs, arena)));
+			Assert::IsTrue(structural_equal(build(lhs, arena), build(rhs, arena)));
+		}
+
+		ZN_TEST_METHOD(StructuralHashTest2)
+		{
+			Arena arena;
+			const Node * lhs = NodeFactory::Variable(arena, 'x');
+			const Node * rhs = NodeFactory::Variable(arena, 'x');
+			for (int i = 0; i < 64; ++i)
+			{
+				lhs = NodeFactory::Binary(arena, NodeKind::Multiplication, lhs, lhs);
+				rhs = NodeFactory::Binary(arena, NodeKind::Multiplication, rhs, rhs);
+			}
+			Assert::IsTrue(structural_equal(DynamicExpression(lhs, arena), DynamicExpression(rhs, arena)));
+			Assert::IsTrue(structural_hash(DynamicExpression(lhs, arena)) == structural_hash(DynamicExpression(rhs, arena)));
+			AnyExpression any = sin(_x) + 1;
+			Assert::IsTrue(structural_equal(any, AnyExpression(sin(_x) + 1)) && structural_hash(any) == structural_hash(AnyExpression(sin(_x) + 1)));
+			Assert::IsTrue(!structural_equal(any, AnyExpression(sin(_x) + 2)) && !structural_equal(any, any.bind('x', 1)));
+			auto expr = _x * _y;
+			Assert::IsTrue(structural_equal(bind_view(expr, _x, 2), bind_view(expr, _x, 2)));
+			Assert::IsTrue(structural_hash(bind_view(expr, _x, 2)) == structural_hash(bind_view(expr, _x, 2)));
+			Assert::IsTrue(!structural_equal(bind_view(expr, _x, 2), bind_view(expr, _x, 3)));
+		}
+
+		ZN_TEST_METHOD(LimitCacheTest1)
+		{
+			LimitCache<> cache(16);
+			auto expr = (power<2>(_x) - 1) / (_x - 1);
+			for (int i = 0; i < 10; ++i)
+			{
+				Assert::IsTrue(lim(_x.to(1), expr, cache) == lim(_x.to(1), expr));
+			}
+			Assert::IsTrue(cache.misses() == 1 && cache.hits() == 9);
+			for (int i = 0; i < 64; ++i) lim(_x.to(i + 2), expr, cache);
+			Assert::IsTrue(cache.size() <= 16);
+			std::atomic<int> mismatches(0);
+			std::vector<std::thread> threads;
+			for (int t = 0; t < 4; ++t)
+			{
+				threads.emplace_back([&]()
+				{
+					for (int i = 0; i < 100; ++i) if (lim(_x.to(i % 8), expr, cache) != (i % 8) + 1) ++mismatches;
+				});
+			}
+			for (auto & thread : threads) thread.join();
+			Assert::IsTrue(mismatches == 0);
+			Assert::IsTrue(cache.hits() + cache.misses() == 474);
+		}
+
+		ZN_TEST_METHOD(CanonicalizeTest1)
+		{
+			auto lhs = canonicalize(_y + 2 * _x + 3 + _x * _y * 4);
+			auto rhs = canonicalize(_y * 4 * _x + 1 + _y + (_x * 2 + 2));
+			bool same = std::is_same<decltype(lhs), decltype(rhs)>::value;
+			Assert::IsTrue(same);
+			Assert::IsTrue(structural_equal(lhs, rhs));
+			Assert::IsTrue(std::get<0>(lhs.m_operands).m_value == 3);
+			Environment<VariableList<'x', 'y'>, double> env;
+			env.Set(_x, 1.5).Set(_y, -2.0);
+			Assert::IsTrue(evaluate(lhs, env) == evaluate(_y + 2 * _x + 3 + _x * _y * 4, env));
+		}
+
+		ZN_TEST_METHOD(CanonicalizeTest2)
+		{
+			auto expr = canonicalize(_x * sin(_x) * _x + _x);
+			auto derived = bind(derive(expr), _x, 0.5L)();
+			auto expected = bind(derive(_x * sin(_x) * _x + _x), _x, 0.5L)();
+			Assert::IsTrue(std::abs(derived - expected) < 1e-15);
+			Arena arena;
+			Assert::IsTrue(std::abs(bind(build(expr, arena), _x, 0.5L)() - bind(expr, _x, 0.5L)()) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(CanonicalizeTest3)
+		{
+			auto lhs = canonicalize(2 * _x + 3 * _x + sin(_y * 5) + sin(_y * 4));
+			auto rhs = canonicalize(sin(4 * _y) + _x * 3 + sin(5 * _y) + _x * 2);
+			bool same = std::is_same<decltype(lhs), decltype(rhs)>::value;
+			Assert::IsTrue(same);
+			Assert::IsTrue(structural_equal(lhs, rhs) && (std::string)lhs == (std::string)rhs);
+			auto named = canonicalize(_x * _pi * 2);
+			Assert::IsTrue(((std::string)named).find("pi") != std::string::npos);
+			Assert::IsTrue(std::abs(bind(named, _x, 0.5L)() - _pi()) < 1e-15);
+			bool ordered = TypeCompare<decltype(_x * _y), decltype(_y * _x)>::value == -TypeCompare<decltype(_y * _x), decltype(_x * _y)>::value;
+			Assert::IsTrue(ordered && TypeCompare<decltype(_x * _y), decltype(_y * _x)>::value != 0);
+		}
+
+		ZN_TEST_METHOD(WriteTest1)
+		{
+			auto expr = (power<2>(_x) + 3) / sin(_x * 2) - -_y + _pi;
+			std::ostringstream stream;
+			write(expr, stream);
+			std::string buffer;
+			write(expr, buffer);
+			Assert::IsTrue(stream.str() == "((((((x)^2)+3)/sin((x*2)))-(-y))+pi)");
+			Assert::IsTrue(buffer == stream.str() && (std::string)expr == buffer);
+			Arena arena;
+			Assert::IsTrue((std::string)build(expr, arena) == buffer);
+		}
+
+		ZN_TEST_METHOD(WriteTest2)
+		{
+			auto expr = (power<2>(_x) + 3) / sin(_x * 2) + sqrt(_x);
+			Assert::IsTrue(print<PrefixFormat>(expr) == "(+ (/ (+ (^2 x) 3) (sin (* x 2))) (sqrt x))");
+			Assert::IsTrue(print<LatexFormat>(expr) == "\\left(\\frac{\\left({x}^{2}+3\\right)}{\\sin\\left(\\left(x \\cdot 2\\right)\\right)}+\\sqrt{x}\\right)");
+		}
+
+		ZN_TEST_METHOD(ImageTest1)
+		{
+			auto expr = derive(power<3>(_x) * sin(_x) + _y / (_x + _pi) + sqrt(_x) * log(_y));
+			std::vector<char> buffer;
+			serialize(expr, buffer);
+			ExpressionImage image;
+			Assert::IsTrue(image.Load(buffer.data(), buffer.size()));
+			DynamicEnvironment env;
+			env.Set(_x, 0.7L).Set(_y, 1.3L);
+			std::vector<long double> scratch(image.Size());
+			long double expected = bind(bind(expr, _x, 0.7L), _y, 1.3L)();
+			Assert::IsTrue(std::abs(image(env) - expected) < 1e-15);
+			Assert::IsTrue(std::abs(image(env, scratch.data()) - expected) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(ImageTest2)
+		{
+			auto expr = sin(_x) * sin(_x) + sin(_x);
+			std::vector<char> shared;
+			std::vector<char> unshared;
+			serialize(expr, shared);
+			serialize(expr, unshared, false);
+			ExpressionImage image;
+			Assert::IsTrue(image.Load(unshared.data(), unshared.size()) && image.Size() == 8);
+			Assert::IsTrue(image.Load(shared.data(), shared.size()) && image.Size() == 4);
+			Assert::IsTrue(!image.Load(shared.data(), sizeof(ImageHeader) - 1));
+			shared[4] = 2;
+			Assert::IsTrue(!image.Load(shared.data(), shared.size()));
+		}
+
+		ZN_TEST_METHOD(ImageTest3)
+		{
+			Arena arena;
+			const Node * node = NodeFactory::Variable(arena, 'x');
+			for (int i = 0; i < 64; ++i) node = NodeFactory::Binary(arena, NodeKind::Addition, node, node);
+			std::vector<char> buffer;
+			serialize(DynamicExpression(node, arena), buffer, false);
+			ExpressionImage image;
+			Assert::IsTrue(image.Load(buffer.data(), buffer.size()) && image.Size() == 65);
+			DynamicEnvironment env;
+			env.Set(_x, 1);
+			std::vector<long double> scratch(image.Size());
+			Assert::IsTrue(image(env, scratch.data()) == std::ldexp(1.0L, 64));
+		}
+
+		ZN_TEST_METHOD(PolynomialTest1)
+		{
+			auto expr = (power<3>(_x) * 2 - _x * (_x + 4)) / 2 + 7;
+			auto poly = polynomial(_x, expr);
+			bool same = std::is_same<decltype(poly), Polynomial<'x', 3, long double> >::value;
+			Assert::IsTrue(same);
+			Assert::IsTrue(poly.m_coefficients[0] == 7 && poly.m_coefficients[1] == -2 && poly.m_coefficients[2] == -0.5L && poly.m_coefficients[3] == 1);
+			Assert::IsTrue(std::abs(bind(poly, _x, 1.5L)() - bind(expr, _x, 1.5L)()) < 1e-15);
+			auto derivative = derive(derive(derive(derive(derive(poly)))));
+			bool fixed = sizeof(derivative) <= sizeof(poly);
+			Assert::IsTrue(fixed);
+			Assert::IsTrue(bind(derive(poly), _x, 2)() == 3 * 2 * 2 - 2 - 2);
+		}
+
+		ZN_TEST_METHOD(PolynomialTest2)
+		{
+			auto expr = sin(power<2>(_x) + 1) * (_x - 3) + _y;
+			auto poly = polynomial(_x, expr);
+			bool same = std::is_same<decltype(poly), BinarryExpression<Addition, BinarryExpression<Multiplication, FunctionExpression<Sinus, Polynomial<'x', 2, long double> >, Polynomial<'x', 1, long double> >, Variable<'y'> > >::value;
+			Assert::IsTrue(same);
+			DynamicEnvironment env;
+			env.Set(_x, 0.3L).Set(_y, 2);
+			Assert::IsTrue(std::abs(evaluate(poly, env) - evaluate(expr, env)) < 1e-15);
+			Assert::IsTrue(std::abs(bind(bind(derive(poly), _x, 0.3L), _y, 2)() - bind(bind(derive(expr), _x, 0.3L), _y, 2)()) < 1e-15);
+			Assert::IsTrue(std::string(polynomial(_x, _x * 2 + 1)) == "(1.000000+(x*2.000000))");
+		}
+
+		ZN_TEST_METHOD(RationalLimitTest1)
+		{
+			auto expr = (power<7>(_x - 1) * 3 + power<8>(_x - 1)) / power<7>(1 - _x);
+			Assert::IsTrue(lim(_x.to(1), expr) == -3);
+			Assert::IsTrue(lim(_x.to(1), power<5>(_x - 1) / power<3>(_x - 1)) == 0);
+			Assert::IsTrue(std::abs(lim(_x.to(0.1L), (power<2>(_x) - 0.01L) / (_x - 0.1L)) - 0.2L) < 1e-15);
+			long double pole = lim(_x.to(0), _x / power<2>(_x));
+			Assert::IsTrue(pole != pole);
+			Assert::IsTrue(lim(_x.to(0), 1 / power<2>(_x)) == std::numeric_limits<long double>::infinity());
+			Assert::IsTrue(lim(_x.to(0), 1 / -power<2>(_x)) == -std::numeric_limits<long double>::infinity());
+			Assert::IsTrue(lim(_x.to(1), (_x - 1) / -power<3>(_x - 1)) == -std::numeric_limits<long double>::infinity());
+		}
+
+		ZN_TEST_METHOD(RationalLimitTest2)
+		{
+			auto infinity = std::numeric_limits<long double>::infinity();
+			Assert::IsTrue(lim(_x.to(infinity), (3 * power<2>(_x) + 1) / (power<2>(_x) - 5)) == 3);
+			Assert::IsTrue(lim(_x.to(infinity), (_x + 1) / (power<2>(_x) - 5)) == 0);
+			Assert::IsTrue(lim(_x.to(-infinity), power<3>(_x) / (power<2>(_x) + 1)) == -infinity);
+			Assert::IsTrue(lim(_x.to(-infinity), -power<4>(_x) / (power<2>(_x) + 1)) == -infinity);
+			Assert::IsTrue(std::abs(lim(_x.to(infinity), (power<2>(_x * 0.1L) - power<2>(_x) * 0.01L + _x) / (_x + 1)) - 1) < 1e-15);
+			Assert::IsTrue(std::abs(lim(_x.to(infinity), (power<2>(_x * 0.7L) - power<2>(_x) * 0.49L + _x) / (_x + 1)) - 1) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(LayoutTest1)
+		{
+			bool empty = sizeof(_x * _x + sin(_x) / _pi) == 1;
+			Assert::IsTrue(empty);
+			bool numeric = sizeof(_x * 2 + sin(_x)) == sizeof(int) && sizeof(-(-(_x * 2.5))) == sizeof(double);
+			Assert::IsTrue(numeric);
+			bool derivative = sizeof(derive(power<3>(_x) * sin(_x))) == 3 * sizeof(int);
+			Assert::IsTrue(derivative);
+			Assert::IsTrue(std::string(derive(power<3>(_x) * sin(_x))) == "((((3*((x)^2))*1)*sin(x))+(((x)^3)*(cos(x)*1)))");
+		}
+
+		ZN_TEST_METHOD(EvaluateManyTest1)
+		{
+			auto expr = sin(power<2>(_x)) * cos(_x) + _y / _x;
+			auto first = derive(expr);
+			auto second = derive(first);
+			DynamicEnvironment point;
+			point.Set(_x, 0.8L).Set(_y, 1.5L);
+			auto values = evaluate_many(point, expr, first, second);
+			Assert::IsTrue(std::abs(values[0] - evaluate(expr, point)) < 1e-15);
+			Assert::IsTrue(std::abs(values[1] - evaluate(first, point)) < 1e-15);
+			Assert::IsTrue(std::abs(values[2] - evaluate(second, point)) < 1e-14);
+			MultiExpression<3> shared(expr, first, second);
+			size_t separate = MultiExpression<1>(expr).Size() + MultiExpression<1>(first).Size() + MultiExpression<1>(second).Size();
+			Assert::IsTrue(shared.Size() < separate);
+			Assert::IsTrue(shared(point) == values);
+		}
+
+		ZN_TEST_METHOD(OptimizeTest1)
+		{
+			Arena arena;
+			OptimizationReport report;
+			auto cube = optimize(_x * _x * _x, arena, report);
+			Assert::IsTrue(std::string(cube) == "((x)^3)" && report.m_costAfter <= report.m_costBefore);
+			auto reciprocal = optimize(_x / 4 + _y / 2, arena, report);
+			Assert::IsTrue(std::string(reciprocal) == "((0.250000*x)+(0.500000*y))" && report.m_costAfter < report.m_costBefore);
+			auto quotient = optimize((_x / _y) / (_y / (_x + 1)), arena, report);
+			Assert::IsTrue(std::string(quotient) == "((x*(x+1))/((y)^2))" && report.m_costAfter < report.m_costBefore);
+			auto factored = optimize(sin(_x) * _y + sin(_x) * 3, arena, report);
+			Assert::IsTrue(std::string(factored) == "(sin(x)*(y+3))");
+			Assert::IsTrue(std::string(report) == "cost 83 -> 42, nodes 9 -> 6, rewrites 1");
+		}
+
+		ZN_TEST_METHOD(OptimizeTest2)
+		{
+			auto expr = derive(derive(sin(power<2>(_x)) * cos(_x) + _y / _x));
+			Arena arena;
+			OptimizationReport report;
+			auto optimized = optimize(expr, arena, report);
+			Assert::IsTrue(report.m_costAfter < report.m_costBefore && report.m_nodesAfter < report.m_nodesBefore);
+			DynamicEnvironment env;
+			env.Set(_x, 0.7L).Set(_y, 1.3L);
+			Assert::IsTrue(std::abs(optimized(env) - evaluate(expr, env)) < 1e-15);
+			CostModel model;
+			model.Set(NodeKind::Division, 1);
+			auto kept = optimize(_x / 4, arena, report, model);
+			Assert::IsTrue(std::string(kept) == "(x/4)" && report.m_rewrites == 0);
+			optimize((_x - _y) * 1, arena, report);
+			Assert::IsTrue(report.m_rewrites == 1);
+			optimize((_x * 1) + 0, arena, report);
+			Assert::IsTrue(report.m_rewrites == 2);
+		}
+
+		ZN_TEST_METHOD(SineCosineTest1)
+		{
+			for (long double x : { -7.5L, -3.0L, -0.4L, 0.0L, 0.9L, 2.5L, 10.0L })
+			{
+				auto both = sincos(x);
+				Assert::IsTrue(std::abs(both.first - Sinus()(x)) < 1e-15 && std::abs(both.second - Cosinus()(x)) < 1e-15);
+			}
+			auto tangent = sin(_x * 2) / cos(_x * 2);
+			Assert::IsTrue(std::abs(bind(tangent, _x, 0.3L)() - evaluate(tangent, Environment<VariableList<'x'>, long double>().Set(_x, 0.3L))) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(SineCosineTest3)
+		{
+			auto expr = sin(_x * 2) * cos(_x * 2) + cos(_x * 3);
+			auto fused = fuse(expr);
+			Assert::IsTrue(fused.m_body.m_leftOperand.m_leftOperand.m_shared && fused.m_body.m_leftOperand.m_rightOperand.m_shared);
+			Assert::IsTrue(!fused.m_body.m_rightOperand.m_shared);
+			auto env = Environment<VariableList<'x'>, long double>().Set(_x, 0.3L);
+			Assert::IsTrue(std::abs(evaluate(fused, env) - evaluate(expr, env)) < 1e-15);
+			Assert::IsTrue(std::abs(bind(fused, _x, 0.3L)() - bind(expr, _x, 0.3L)()) < 1e-15);
+			auto derived = derive(sin(_x) * power<3>(cos(_x)));
+			Assert::IsTrue(std::abs(evaluate(fuse(derived), env) - evaluate(derived, env)) < 1e-15);
+			Assert::IsTrue(std::abs(lim(_x.to(0), (sin(_x) * cos(_x)) / _x) - 1) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(SineCosineTest4)
+		{
+			Arena arena;
+			auto built = build(sin(_x * 2) + cos(_x * 2), arena);
+			Assert::IsTrue(built.m_node->m_leftOperand->m_leftOperand == built.m_node->m_rightOperand->m_leftOperand);
+			auto derived = derive(derive(build(sin(_x) * _x, arena)));
+			DynamicEnvironment env;
+			env.Set(_x, 0.7L);
+			auto expected = derive(derive(sin(_x) * _x));
+			Assert::IsTrue(std::abs(derived(env) - evaluate(expected, env)) < 1e-15);
+			Assert::IsTrue(std::abs(bind(derived, _x, 0.7L)() - derived(env)) < 1e-15);
+		}
+
+		ZN_TEST_METHOD(SineCosineTest2)
+		{
+			auto expr = derive(sin(_x * 2) * power<2>(cos(_x * 2)));
+			std::vector<char> buffer;
+			serialize(expr, buffer);
+			ExpressionImage image;
+			Assert::IsTrue(image.Load(buffer.data(), buffer.size()));
+			DynamicEnvironment env;
+			env.Set(_x, 0.6L);
+			std::vector<long double> scratch(image.Size());
+			Assert::IsTrue(std::abs(image(env, scratch.data()) - evaluate(expr, env)) < 1e-15);
+			Assert::IsTrue(std::abs(evaluate_many(env, expr)[0] - evaluate(expr, env)) < 1e-15);
+			ImageNode * nodes = reinterpret_cast<ImageNode *>(buffer.data() + sizeof(ImageHeader));
+			size_t fused = 0;
+			for (size_t i = 0; i < image.Size(); ++i)
+			{
+				if (nodes[i].m_opcode == (std::uint8_t)NodeKind::Sinus && nodes[i].m_rightOperand != 0) ++fused;
+			}
+			Assert::IsTrue(fused == 1);
+			for (size_t i = 0; i < image.Size(); ++i)
+			{
+				if (nodes[i].m_opcode == (std::uint8_t)NodeKind::Cosinus) nodes[i].m_rightOperand = (std::uint32_t)i;
+			}
+			Assert::IsTrue(!image.Load(buffer.data(), buffer.size()));
+		}
 	};
 
 }}
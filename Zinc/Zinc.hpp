@@ -4,7 +4,27 @@
 #include <string>
 #include <sstream>
 #include <type_traits>
+#include <utility>
+#include <limits>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <initializer_list>
+#include <unordered_map>
 
 namespace Zinc
 {
@@ -28,6 +48,32 @@ namespace Zinc
 	template <class T>
 	struct Derivation;
 
+	template <class T>
+	struct Expression;
+
+	template <class T1, class T2>
+	struct Equality;
+
+	template <class T>
+	struct Hasher;
+
+	template <char id, class T>
+	struct PolynomialDegree;
+
+	template <class F, typename T, bool arithmetic = std::is_arithmetic<T>::value>
+	struct FunctionValue;
+
+	template <class Operator, typename T1, typename T2, bool arithmetic = std::is_arithmetic<T1>::value && std::is_arithmetic<T2>::value>
+	struct BinaryValue;
+
+	template <char id, typename V, class T>
+	struct PolynomialCoefficients;
+
+	struct InfixFormat;
+
+	template <class Format = InfixFormat, class T>
+	static inline std::string print(const Expression<T> & expr);
+
 	template <char id, typename T>
 	struct LimitParam
 	{
@@ -39,6 +85,19 @@ namespace Zinc
 		T m_to;
 	};
 
+	template <char id, typename T>
+	struct GridAxis
+	{
+		GridAxis(const T * coordinates, size_t count)
+			: m_coordinates(coordinates),
+			m_count(count)
+		{
+		}
+
+		const T * m_coordinates;
+		size_t m_count;
+	};
+
 	template <class T>
 	struct Expression
 	{
@@ -50,9 +109,7 @@ namespace Zinc
 
 		operator std::string() const
 		{
-			std::ostringstream ss;
-			ss << (std::string)Self();
-			return ss.str();
+			return print(Self());
 		}
 
 	private:
@@ -65,13 +122,8 @@ namespace Zinc
 	template <typename T>
 	struct Numeric : Expression<Numeric<T> >
 	{
-		Numeric(const T & value)
-			: m_value(value)
-		{
-		}
-
-		Numeric(const Numeric & expr)
-			: m_value(expr.m_value)
+		Numeric(T value)
+			: m_value(std::move(value))
 		{
 		}
 
@@ -82,7 +134,7 @@ namespace Zinc
 
 		operator std::string() const
 		{
-			return std::to_string(m_value);
+			return print(*this);
 		}
 
 		T m_value;
@@ -98,7 +150,7 @@ namespace Zinc
 
 		operator std::string() const
 		{
-			return TypeTraits<Constant<T, N, D> >::name;
+			return print(*this);
 		}
 	};
 
@@ -112,7 +164,7 @@ namespace Zinc
 
 		operator std::string() const
 		{
-			return std::string(1, id);
+			return print(*this);
 		}
 
 		template <typename T>
@@ -120,6 +172,12 @@ namespace Zinc
 		{
 			return{ to };
 		}
+
+		template <typename T>
+		GridAxis<id, T> over(const T * coordinates, size_t count) const
+		{
+			return{ coordinates, count };
+		}
 	};
 
 	static constexpr Constant<long double, 314159265358979, 100000000000000> _pi{};
@@ -217,9 +275,9 @@ namespace Zinc
 	{
 	public:
 		template <typename T1, typename T2>
-		auto operator()(const T1 && lhs, const T2 && rhs) const
+		auto operator()(T1 && lhs, T2 && rhs) const
 		{
-			return lhs + rhs;
+			return std::forward<T1>(lhs) + std::forward<T2>(rhs);
 		}
 
 		operator std::string() const
@@ -232,9 +290,9 @@ namespace Zinc
 	{
 	public:
 		template <typename T1, typename T2>
-		auto operator()(const T1 && lhs, const T2 && rhs) const
+		auto operator()(T1 && lhs, T2 && rhs) const
 		{
-			return lhs - rhs;
+			return std::forward<T1>(lhs) - std::forward<T2>(rhs);
 		}
 
 		operator std::string() const
@@ -247,9 +305,9 @@ namespace Zinc
 	{
 	public:
 		template <typename T1, typename T2>
-		auto operator()(const T1 && lhs, const T2 && rhs) const
+		auto operator()(T1 && lhs, T2 && rhs) const
 		{
-			return lhs * rhs;
+			return std::forward<T1>(lhs) * std::forward<T2>(rhs);
 		}
 
 		operator std::string() const
@@ -258,6 +316,22 @@ namespace Zinc
 		}
 	};
 
+	template <typename T>
+	struct FloatType
+	{
+		typedef typename std::conditional<std::is_floating_point<T>::value, T, long double>::type type;
+	};
+
+	template <typename T1, typename T2>
+	struct DivisionType
+	{
+		typedef typename std::conditional<
+			std::is_floating_point<T1>::value || std::is_floating_point<T2>::value,
+			typename std::common_type<T1, T2>::type,
+			long double
+		>::type type;
+	};
+
 	template <typename T1, typename T2, bool fund>
 	struct Div
 	{
@@ -271,7 +345,8 @@ namespace Zinc
 	{
 		static inline auto Get(const T1 & lhs, const T2 & rhs)
 		{
-			return (long double)lhs / (long double)rhs;
+			typedef typename DivisionType<T1, T2>::type type;
+			return (type)lhs / (type)rhs;
 		}
 	};
 
@@ -279,9 +354,11 @@ namespace Zinc
 	{
 	public:
 		template <typename T1, typename T2>
-		auto operator()(const T1 && lhs, const T2 && rhs) const
+		auto operator()(T1 && lhs, T2 && rhs) const
 		{
-			return Div<T1, T2, std::is_fundamental<T1>::value || std::is_fundamental<T2>::value>::Get(lhs, rhs);
+			typedef typename std::decay<T1>::type type1;
+			typedef typename std::decay<T2>::type type2;
+			return Div<type1, type2, std::is_fundamental<type1>::value || std::is_fundamental<type2>::value>::Get(lhs, rhs);
 		}
 
 		operator std::string() const
@@ -310,15 +387,6 @@ namespace Zinc
 	template <int p, bool s>
 	struct PowBase;
 	template <int p>
-	struct PowBase<p, false>
-	{
-		template <typename T>
-		static inline auto Get(const T & value)
-		{
-			return value * PowBase<p - 1, false>::Get(value);
-		}
-	};
-	template <int p>
 	struct PowBase<p, true>
 	{
 		template <typename T>
@@ -346,6 +414,44 @@ namespace Zinc
 		}
 	};
 
+	template <bool odd>
+	struct PowSquare
+	{
+		template <typename T1, typename T2>
+		static inline auto Get(const T1 & half, const T2 &)
+		{
+			return half * half;
+		}
+	};
+	template <>
+	struct PowSquare<true>
+	{
+		template <typename T1, typename T2>
+		static inline auto Get(const T1 & half, const T2 & value)
+		{
+			return half * half * value;
+		}
+	};
+
+	template <int p>
+	struct PowBase<p, false>
+	{
+		template <typename T>
+		static inline auto Get(const T & value)
+		{
+			return PowSquare<p % 2 == 1>::Get(PowBase<p / 2, false>::Get(value), value);
+		}
+	};
+	template <>
+	struct PowBase<1, false>
+	{
+		template <typename T>
+		static inline auto Get(const T & value)
+		{
+			return value * PowBase<0, false>::Get(value);
+		}
+	};
+
 	template<int p>
 	struct Pow : PowBase<p, p < 0> {};
 
@@ -354,7 +460,7 @@ namespace Zinc
 	{
 	public:
 		template <typename T>
-		auto operator()(const T && operand) const
+		auto operator()(T && operand) const
 		{
 			return Pow<p>::Get(operand);
 		}
@@ -367,135 +473,251 @@ namespace Zinc
 		}
 	};
 
-	template <class Operator, class Operand>
-	struct UnaryExpression : Expression<UnaryExpression<Operator, Operand> >
+	struct IntegerPower
 	{
 	public:
-		UnaryExpression(const Operand& operand)
-			: m_operand(operand)
+		template <typename T>
+		static inline T Get(T value, int p)
 		{
+			unsigned n = p < 0 ? 0u - (unsigned)p : (unsigned)p;
+			if (n == 0) return 1;
+			for (; !(n & 1); n >>= 1) value = value * value;
+			T result = value;
+			while (n >>= 1)
+			{
+				value = value * value;
+				if (n & 1) result = result * value;
+			}
+			return p < 0 ? 1 / result : result;
 		}
 
-		UnaryExpression(const UnaryExpression& expr)
-			: m_operand(expr.m_operand)
+		template <typename T1, typename T2>
+		static inline T1 Value(const T1 & lhs, const T2 & rhs)
 		{
+			return Get<T1>(lhs, (int)rhs);
 		}
 
-		auto operator()() const
+		template <typename T1, typename T2>
+		auto operator()(T1 && lhs, T2 && rhs) const
 		{
-			return m_operation(m_operand());
+			return BinaryValue<IntegerPower, typename std::decay<T1>::type, int>::Get(lhs, (int)rhs);
 		}
 
 		operator std::string() const
 		{
-			std::ostringstream ss;
-			ss << "(";
-			ss << (std::string)m_operation;
-			ss << (std::string)m_operand;
-			ss << ")";
-			return ss.str();
+			return "^";
 		}
+	};
 
-		Operator m_operation;
-		Operand m_operand;
+#ifdef _MSC_VER
+	#define ZINC_EMPTY_BASES __declspec(empty_bases)
+#else
+	#define ZINC_EMPTY_BASES
+#endif
+
+	template <class Node, class T, bool empty = std::is_empty<T>::value>
+	struct OperandMember
+	{
+		OperandMember() = default;
+
+		OperandMember(T operand)
+			: m_operand(std::move(operand))
+		{
+		}
+
+		T m_operand;
 	};
+	template <class Node, class T>
+	struct OperandMember<Node, T, true>
+	{
+		OperandMember() = default;
 
-	template <class Operator, class Operand>
-	struct PostfixExpression : Expression<PostfixExpression<Operator, Operand> >
+		OperandMember(T)
+		{
+		}
+
+		static const T m_operand;
+	};
+	template <class Node, class T>
+	const T OperandMember<Node, T, true>::m_operand{};
+
+	template <class Node, class T, bool empty = std::is_empty<T>::value>
+	struct LeftOperandMember
 	{
-		PostfixExpression(const Operand& operand)
-			: m_operand(operand)
+		LeftOperandMember() = default;
+
+		LeftOperandMember(T operand)
+			: m_leftOperand(std::move(operand))
 		{
 		}
 
-		PostfixExpression(const PostfixExpression& expr)
-			: m_operand(expr.m_operand)
+		T m_leftOperand;
+	};
+	template <class Node, class T>
+	struct LeftOperandMember<Node, T, true>
+	{
+		LeftOperandMember() = default;
+
+		LeftOperandMember(T)
 		{
 		}
 
-		auto operator()() const
+		static const T m_leftOperand;
+	};
+	template <class Node, class T>
+	const T LeftOperandMember<Node, T, true>::m_leftOperand{};
+
+	template <class Node, class T, bool empty = std::is_empty<T>::value>
+	struct RightOperandMember
+	{
+		RightOperandMember() = default;
+
+		RightOperandMember(T operand)
+			: m_rightOperand(std::move(operand))
 		{
-			return m_operation(m_operand());
 		}
 
-		operator std::string() const
+		T m_rightOperand;
+	};
+	template <class Node, class T>
+	struct RightOperandMember<Node, T, true>
+	{
+		RightOperandMember() = default;
+
+		RightOperandMember(T)
 		{
-			std::ostringstream ss;
-			ss << "((";
-			ss << (std::string)m_operand;
-			ss << ")";
-			ss << (std::string)m_operation;
-			ss << ")";
-			return ss.str();
 		}
 
-		Operator m_operation;
-		Operand m_operand;
+		static const T m_rightOperand;
 	};
+	template <class Node, class T>
+	const T RightOperandMember<Node, T, true>::m_rightOperand{};
 
-	template <class Operator, class LeftOperand, class RightOperand>
-	struct BinarryExpression : Expression<BinarryExpression<Operator, LeftOperand, RightOperand> >
+	template <class Node, class T, bool empty = std::is_empty<T>::value>
+	struct OperationMember
+	{
+		T m_operation;
+	};
+	template <class Node, class T>
+	struct OperationMember<Node, T, true>
+	{
+		static const T m_operation;
+	};
+	template <class Node, class T>
+	const T OperationMember<Node, T, true>::m_operation{};
+
+	template <class Node, class T, bool empty = std::is_empty<T>::value>
+	struct FunctionMember
+	{
+		T m_function;
+	};
+	template <class Node, class T>
+	struct FunctionMember<Node, T, true>
+	{
+		static const T m_function;
+	};
+	template <class Node, class T>
+	const T FunctionMember<Node, T, true>::m_function{};
+
+	template <class Operator, class Operand>
+	struct ZINC_EMPTY_BASES UnaryExpression
+		: Expression<UnaryExpression<Operator, Operand> >,
+		OperationMember<UnaryExpression<Operator, Operand>, Operator>,
+		OperandMember<UnaryExpression<Operator, Operand>, Operand>
 	{
 	public:
-		BinarryExpression(const LeftOperand& leftOperand, const RightOperand& rightOperand)
-			: m_leftOperand(leftOperand),
-			m_rightOperand(rightOperand)
+		UnaryExpression() = default;
+
+		UnaryExpression(Operand operand)
+			: OperandMember<UnaryExpression<Operator, Operand>, Operand>(std::move(operand))
 		{
 		}
 
-		BinarryExpression(const BinarryExpression & expr)
-			: m_leftOperand(expr.m_leftOperand),
-			m_rightOperand(expr.m_rightOperand)
+		auto operator()() const
+		{
+			return this->m_operation(this->m_operand());
+		}
+
+		operator std::string() const
+		{
+			return print(*this);
+		}
+	};
+
+	template <class Operator, class Operand>
+	struct ZINC_EMPTY_BASES PostfixExpression
+		: Expression<PostfixExpression<Operator, Operand> >,
+		OperationMember<PostfixExpression<Operator, Operand>, Operator>,
+		OperandMember<PostfixExpression<Operator, Operand>, Operand>
+	{
+		PostfixExpression() = default;
+
+		PostfixExpression(Operand operand)
+			: OperandMember<PostfixExpression<Operator, Operand>, Operand>(std::move(operand))
 		{
 		}
 
 		auto operator()() const
 		{
-			return m_operation(m_leftOperand(), m_rightOperand());
+			return this->m_operation(this->m_operand());
 		}
 
 		operator std::string() const
 		{
-			std::ostringstream ss;
-			ss << "(";
-			ss << (std::string)m_leftOperand;
-			ss << (std::string)m_operation;
-			ss << (std::string)m_rightOperand;
-			ss << ")";
-			return ss.str();
+			return print(*this);
 		}
+	};
 
-		Operator m_operation;
-		LeftOperand m_leftOperand;
-		RightOperand m_rightOperand;
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct ZINC_EMPTY_BASES BinarryExpression
+		: Expression<BinarryExpression<Operator, LeftOperand, RightOperand> >,
+		OperationMember<BinarryExpression<Operator, LeftOperand, RightOperand>, Operator>,
+		LeftOperandMember<BinarryExpression<Operator, LeftOperand, RightOperand>, LeftOperand>,
+		RightOperandMember<BinarryExpression<Operator, LeftOperand, RightOperand>, RightOperand>
+	{
+	public:
+		BinarryExpression() = default;
+
+		BinarryExpression(LeftOperand leftOperand, RightOperand rightOperand)
+			: LeftOperandMember<BinarryExpression<Operator, LeftOperand, RightOperand>, LeftOperand>(std::move(leftOperand)),
+			RightOperandMember<BinarryExpression<Operator, LeftOperand, RightOperand>, RightOperand>(std::move(rightOperand))
+		{
+		}
+
+		auto operator()() const
+		{
+			return this->m_operation(this->m_leftOperand(), this->m_rightOperand());
+		}
+
+		operator std::string() const
+		{
+			return print(*this);
+		}
 	};
 
 	template <class F, class T>
-	struct FunctionExpression : Expression<FunctionExpression<F, T> >
+	struct ZINC_EMPTY_BASES FunctionExpression
+		: Expression<FunctionExpression<F, T> >,
+		FunctionMember<FunctionExpression<F, T>, F>,
+		OperandMember<FunctionExpression<F, T>, T>
 	{
 	public:
-		FunctionExpression(const T& operand)
-			: m_operand(operand)
+		FunctionExpression() = default;
+
+		FunctionExpression(T operand)
+			: OperandMember<FunctionExpression<F, T>, T>(std::move(operand))
 		{
 		}
 
 		auto operator()() const
 		{
-			return m_function(m_operand());
+			return this->m_function(this->m_operand());
 		}
 
 		operator std::string() const
 		{
-			std::ostringstream ss;
-			ss << (std::string)m_function;
-			ss << "(";
-			ss << (std::string)m_operand;
-			ss << ")";
-			return ss.str();
+			return print(*this);
 		}
-
-		T m_operand;
-		F m_function;
 	};
 
 	template <typename T, bool fund>
@@ -519,12 +741,60 @@ namespace Zinc
 	template <typename T>
 	struct ExpressionOperator : ExpressionOperatorBase<T, std::is_base_of<Expression<T>, T>::value > { };
 
+	template <typename Lhs, typename Rhs>
+	struct ExpressionOperands
+	{
+		static constexpr bool value = std::is_base_of<Expression<Lhs>, Lhs>::value || std::is_base_of<Expression<Rhs>, Rhs>::value;
+	};
+
+	// Numeric operands go to the operator's kernel. Symbolic operands, as produced by
+	// evaluating a tree that still has free variables, rebuild the node instead.
+	template <class F, typename T>
+	struct FunctionValue<F, T, true>
+	{
+		static inline auto Get(const T & operand)
+		{
+			return F::Value(operand);
+		}
+	};
+	template <class F, typename T>
+	struct FunctionValue<F, T, false>
+	{
+		static inline FunctionExpression<F, typename ExpressionOperator<T>::type> Get(const T & operand)
+		{
+			return{ ExpressionOperator<T>::GetParam(operand) };
+		}
+	};
+
+	template <class Operator, typename T1, typename T2>
+	struct BinaryValue<Operator, T1, T2, true>
+	{
+		static inline auto Get(const T1 & lhs, const T2 & rhs)
+		{
+			return Operator::Value(lhs, rhs);
+		}
+	};
+	template <class Operator, typename T1, typename T2>
+	struct BinaryValue<Operator, T1, T2, false>
+	{
+		static inline BinarryExpression<Operator, typename ExpressionOperator<T1>::type, typename ExpressionOperator<T2>::type> Get(const T1 & lhs, const T2 & rhs)
+		{
+			return{ ExpressionOperator<T1>::GetParam(lhs), ExpressionOperator<T2>::GetParam(rhs) };
+		}
+	};
+
 	template <int p, typename T>
 	static inline PostfixExpression<Power<p>, typename ExpressionOperator<T>::type> power(const T & value)
 	{
 		return{ ExpressionOperator<T>::GetParam(value) };
 	}
 
+	template <typename T>
+	static inline BinarryExpression<IntegerPower, typename ExpressionOperator<T>::type, Numeric<int> > power(const T & value, int p)
+	{
+		return{ ExpressionOperator<T>::GetParam(value), p };
+	}
+
 	template <typename T>
 	struct HasVariables
 	{
@@ -551,949 +821,8079 @@ namespace Zinc
 		static constexpr bool value = HasVariables<T2>::value || HasVariables<T3>::value;
 	};
 	template <class T1, class T2>
+	struct HasVariables<PostfixExpression<T1, T2> >
+	{
+		static constexpr bool value = HasVariables<T2>::value;
+	};
+	template <class T1, class T2>
 	struct HasVariables<FunctionExpression<T1, T2> >
 	{
 		static constexpr bool value = HasVariables<T2>::value;
 	};
 
-	template <typename T1, intmax_t N, intmax_t D, typename T2, typename T3>
-	struct Binder<Constant<T1, N, D>, T2, T3>
+	template <char... ids>
+	struct VariableList
 	{
-		typedef Constant<T1, N, D> type;
-		static inline type Bind(const Constant<T1, N, D>& exp, const T2&, const T3&)
-		{
-			return exp;
-		}
+		static constexpr size_t size = sizeof...(ids);
 	};
 
-	template <typename T1, typename T2, typename T3>
-	struct Binder<Numeric<T1>, T2, T3>
+	template <class L, char id>
+	struct VariableListContains;
+	template <char id>
+	struct VariableListContains<VariableList<>, id>
 	{
-		typedef Numeric<T1> type;
-		static inline type Bind(const Numeric<T1>& exp, const T2&, const T3&)
-		{
-			return exp;
-		}
+		static constexpr bool value = false;
 	};
-
-	template <char id, typename T>
-	struct Binder<Variable<id>, Variable<id>, T>
+	template <char head, char... tail, char id>
+	struct VariableListContains<VariableList<head, tail...>, id>
 	{
-		typedef T type;
-		static inline type Bind(const Variable<id>&, const Variable<id>&, const T& value)
-		{
-			return value;
-		}
+		static constexpr bool value = head == id || VariableListContains<VariableList<tail...>, id>::value;
 	};
 
-	template <char id1, char id2, typename T>
-	struct Binder<Variable<id1>, Variable<id2>, T>
+	template <class L, char id, bool contains = VariableListContains<L, id>::value>
+	struct VariableListInsert
 	{
-		typedef Variable<id1> type;
-		static inline type Bind(const Variable<id1>& exp, const Variable<id2>&, const T&)
-		{
-			return exp;
-		}
+		typedef L type;
+	};
+	template <char... ids, char id>
+	struct VariableListInsert<VariableList<ids...>, id, false>
+	{
+		typedef VariableList<ids..., id> type;
 	};
 
-	template <class Operator, class Operand, class T1, typename T2>
-	struct Binder<UnaryExpression<Operator, Operand>, T1, T2>
+	template <class L1, class L2>
+	struct VariableListUnion;
+	template <class L1>
+	struct VariableListUnion<L1, VariableList<> >
 	{
-		typedef UnaryExpression<Operator, typename Binder<Operand, T1, T2>::type> type;
-		static inline type Bind(const UnaryExpression<Operator, Operand>& exp, const T1& var, const T2& value)
-		{
-			return{ Binder<Operand, T1, T2>::Bind(exp.m_operand, var, value) };
-		}
+		typedef L1 type;
+	};
+	template <class L1, char head, char... tail>
+	struct VariableListUnion<L1, VariableList<head, tail...> >
+	{
+		typedef typename VariableListUnion<typename VariableListInsert<L1, head>::type, VariableList<tail...> >::type type;
 	};
 
-	template <class Operator, class LeftOperand, class RightOperand, class T1, typename T2>
-	struct Binder<BinarryExpression<Operator, LeftOperand, RightOperand>, T1, T2>
+	template <class L>
+	struct VariableListHas;
+	template <>
+	struct VariableListHas<VariableList<> >
 	{
-		typedef BinarryExpression<Operator, typename Binder<LeftOperand, T1, T2>::type, typename Binder<RightOperand, T1, T2>::type> type;
-		static inline type Bind(const BinarryExpression<Operator, LeftOperand, RightOperand>& exp, const T1& var, const T2& value)
+		static constexpr bool Get(char)
 		{
-			return{ Binder<LeftOperand, T1, T2>::Bind(exp.m_leftOperand, var, value), Binder<RightOperand, T1, T2>::Bind(exp.m_rightOperand, var, value) };
+			return false;
 		}
 	};
-
-	template <int p, class T, class T1, typename T2>
-	struct Binder<PostfixExpression<Power<p>, T>, T1, T2>
+	template <char head, char... tail>
+	struct VariableListHas<VariableList<head, tail...> >
 	{
-		typedef PostfixExpression<Power<p>, typename Binder<T, T1, T2>::type> type;
-		static inline type Bind(const PostfixExpression<Power<p>, T> & exp, const T1& var, const T2& value)
+		static constexpr bool Get(char id)
 		{
-			return{ Binder<T, T1, T2>::Bind(exp.m_operand, var, value) };
+			return head == id || VariableListHas<VariableList<tail...> >::Get(id);
 		}
 	};
 
-	template <class F, class T1, class T2, typename T3>
-	struct Binder<FunctionExpression<F, T1>, T2, T3>
+	template <typename T>
+	struct Variables
 	{
-		typedef FunctionExpression<F, typename Binder<T1, T2, T3>::type> type;
-		static inline type Bind(const FunctionExpression<F, T1>& exp, const T2& var, const T3& value)
-		{
-			return{ Binder<T1, T2, T3>::Bind(exp.m_operand, var, value) };
-		}
+		typedef VariableList<> type;
 	};
-
-	template <class T1, class T2, typename T3>
-	struct Binder<Expression<T1>, T2, T3>
+	template <typename T>
+	struct Variables<Expression<T> >
 	{
-		typedef typename Binder<T1, T2, T3>::type type;
-		static inline type Bind(const T1& exp, const T2& var, const T3& value)
-		{
-			return Binder<T1, T2, T3>::Bind(exp, var, value);
-		}
+		typedef typename Variables<T>::type type;
 	};
-
-	template <size_t terms, typename T>
-	struct TaylorSineTerm
+	template <char id>
+	struct Variables<Variable<id> >
 	{
-		static inline auto Get(const T & x)
-		{
-			return (power<terms>(-1) / (long double)factorial<(2 * terms) + 1>()) * power<(2 * terms) + 1>(x);
-		}
+		typedef VariableList<id> type;
 	};
-	template<size_t terms, typename T>
-	struct TaylorSine
+	template <class T1, class T2>
+	struct Variables<UnaryExpression<T1, T2> >
 	{
-		static inline auto Get(const T & x)
-		{
-			return TaylorSineTerm<terms, T>::Get(x) + TaylorSine<terms - 1, T>::Get(x);
-		}
+		typedef typename Variables<T2>::type type;
 	};
-	template <typename T>
-	struct TaylorSine<0, T>
+	template <class T1, class T2>
+	struct Variables<PostfixExpression<T1, T2> >
 	{
-		static inline auto Get(const T & x)
-		{
-			return TaylorSineTerm<0, T>::Get(x);
-		}
+		typedef typename Variables<T2>::type type;
+	};
+	template <class T1, class T2, class T3>
+	struct Variables<BinarryExpression<T1, T2, T3> >
+	{
+		typedef typename VariableListUnion<typename Variables<T2>::type, typename Variables<T3>::type>::type type;
+	};
+	template <class T1, class T2>
+	struct Variables<FunctionExpression<T1, T2> >
+	{
+		typedef typename Variables<T2>::type type;
 	};
 
-	template <size_t terms, typename T>
-	struct TaylorCosineTerm
+	template <class T, bool variables>
+	struct StagerBase
 	{
-		static inline auto Get(const T & x)
+		typedef Numeric<decltype(std::declval<const T &>()())> type;
+		static inline type Stage(const T & expr)
 		{
-			return (power<terms>(-1) / (long double)factorial<(2 * terms)>()) * power<(2 * terms)>(x);
+			return{ expr() };
 		}
 	};
-	template<size_t terms, typename T>
-	struct TaylorCosine
+	template <char id>
+	struct StagerBase<Variable<id>, true>
 	{
-		static inline auto Get(const T & x)
+		typedef Variable<id> type;
+		static inline type Stage(const Variable<id> & expr)
 		{
-			return TaylorCosineTerm<terms, T>::Get(x) + TaylorCosine<terms - 1, T>::Get(x);
+			return expr;
 		}
 	};
-	template <typename T>
-	struct TaylorCosine<0, T>
+	template <class Operator, class Operand>
+	struct StagerBase<UnaryExpression<Operator, Operand>, true>
 	{
-		static inline auto Get(const T & x)
+		typedef UnaryExpression<Operator, typename StagerBase<Operand, HasVariables<Operand>::value>::type> type;
+		static inline type Stage(const UnaryExpression<Operator, Operand> & expr)
 		{
-			return TaylorCosineTerm<0, T>::Get(x);
+			return{ StagerBase<Operand, HasVariables<Operand>::value>::Stage(expr.m_operand) };
 		}
 	};
-
-	template <size_t terms, typename T>
-	struct TaylorETerm
+	template <class Operator, class Operand>
+	struct StagerBase<PostfixExpression<Operator, Operand>, true>
 	{
-		static inline auto Get(const T & x)
+		typedef PostfixExpression<Operator, typename StagerBase<Operand, HasVariables<Operand>::value>::type> type;
+		static inline type Stage(const PostfixExpression<Operator, Operand> & expr)
 		{
-			return power<terms>(x) / (long double)factorial<terms>();
+			return{ StagerBase<Operand, HasVariables<Operand>::value>::Stage(expr.m_operand) };
 		}
 	};
-	template<size_t terms, typename T>
-	struct TaylorE
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct StagerBase<BinarryExpression<Operator, LeftOperand, RightOperand>, true>
 	{
-		static inline auto Get(const T & x)
+		typedef BinarryExpression<
+			Operator,
+			typename StagerBase<LeftOperand, HasVariables<LeftOperand>::value>::type,
+			typename StagerBase<RightOperand, HasVariables<RightOperand>::value>::type
+		> type;
+		static inline type Stage(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
 		{
-			return TaylorETerm<terms, T>::Get(x) + TaylorE<terms - 1, T>::Get(x);
+			return
+			{
+				StagerBase<LeftOperand, HasVariables<LeftOperand>::value>::Stage(expr.m_leftOperand),
+				StagerBase<RightOperand, HasVariables<RightOperand>::value>::Stage(expr.m_rightOperand)
+			};
 		}
 	};
-	template <typename T>
-	struct TaylorE<0, T>
+	template <class F, class T>
+	struct StagerBase<FunctionExpression<F, T>, true>
 	{
-		static inline auto Get(const T & x)
+		typedef FunctionExpression<F, typename StagerBase<T, HasVariables<T>::value>::type> type;
+		static inline type Stage(const FunctionExpression<F, T> & expr)
 		{
-			return TaylorETerm<0, T>::Get(x);
+			return{ StagerBase<T, HasVariables<T>::value>::Stage(expr.m_operand) };
 		}
 	};
 
-	template <typename T, bool fund>
-	struct TypeToFloatBase
+	template <class T>
+	struct Stager : StagerBase<T, HasVariables<T>::value>
 	{
-		typedef T type;
 	};
-	template <typename T>
-	struct TypeToFloatBase<T, true>
+	template <class T>
+	struct Stager<Expression<T> > : Stager<T>
 	{
-		typedef double long type;
 	};
 
-	template <typename T>
-	struct TypeToFloat : TypeToFloatBase<T, std::is_fundamental<T>::value>
+	template <class T>
+	static inline typename Stager<T>::type stage(const Expression<T> & expr)
 	{
-	};
+		return Stager<T>::Stage(expr());
+	}
 
-	template <size_t terms, typename T>
-	struct TaylorLnTerm
+	template <typename T1, intmax_t N, intmax_t D, typename T2, typename T3>
+	struct Binder<Constant<T1, N, D>, T2, T3>
 	{
-		static inline auto Get(const T & x)
+		typedef Constant<T1, N, D> type;
+		static inline type Bind(const Constant<T1, N, D>& exp, const T2&, const T3&)
 		{
-			return 2 * (power<(2*terms)-1>((x-1)/(x+1)) / ((2 * terms) - 1));
+			return exp;
 		}
 	};
-	template<size_t terms, typename T>
-	struct TaylorLn
+
+	template <typename T1, typename T2, typename T3>
+	struct Binder<Numeric<T1>, T2, T3>
 	{
-		static inline auto Get(const T & x)
+		typedef Numeric<T1> type;
+		static inline type Bind(const Numeric<T1>& exp, const T2&, const T3&)
 		{
-			return TaylorLnTerm<terms, T>::Get(x) + TaylorLn<terms - 1, T>::Get(x);
+			return exp;
 		}
 	};
-	template <typename T>
-	struct TaylorLn<1, T>
+
+	template <char id, typename T>
+	struct Binder<Variable<id>, Variable<id>, T>
 	{
-		static inline auto Get(const T & x)
+		typedef T type;
+		static inline type Bind(const Variable<id>&, const Variable<id>&, const T& value)
 		{
-			return TaylorLnTerm<1, T>::Get(x);
+			return value;
 		}
 	};
 
-	template <typename T>
-	static inline auto ln(const T & value)
+	template <char id1, char id2, typename T>
+	struct Binder<Variable<id1>, Variable<id2>, T>
 	{
-		return TaylorLn<
-			CONFIDENCE_LEVEL,
-			typename TypeToFloat<T>::type
-		>::Get((typename TypeToFloat<T>::type)value);
-	}
+		typedef Variable<id1> type;
+		static inline type Bind(const Variable<id1>& exp, const Variable<id2>&, const T&)
+		{
+			return exp;
+		}
+	};
 
-	template <class T, bool numeric>
-	struct RadianReductionBase
+	template <class Operator, class Operand, class T1, typename T2>
+	struct Binder<UnaryExpression<Operator, Operand>, T1, T2>
 	{
-		typedef long double type;
-		static inline type Get(type value)
+		typedef UnaryExpression<Operator, typename Binder<Operand, T1, T2>::type> type;
+		static inline type Bind(const UnaryExpression<Operator, Operand>& exp, const T1& var, const T2& value)
 		{
-			if (value > _pi())
-			{
-				value -= _2pi();
-				return Get(value);
-			}
-			else if (value < -_pi())
-			{
-				value += _2pi();
-				return Get(value);
-			}
-			else return value;
+			return{ Binder<Operand, T1, T2>::Bind(exp.m_operand, var, value) };
 		}
 	};
-	template <class T>
-	struct RadianReductionBase<T, false>
+
+	template <class Operator, class LeftOperand, class RightOperand, class T1, typename T2>
+	struct Binder<BinarryExpression<Operator, LeftOperand, RightOperand>, T1, T2>
 	{
-		typedef T type;
-		static inline type Get(type & value)
+		typedef BinarryExpression<Operator, typename Binder<LeftOperand, T1, T2>::type, typename Binder<RightOperand, T1, T2>::type> type;
+		static inline type Bind(const BinarryExpression<Operator, LeftOperand, RightOperand>& exp, const T1& var, const T2& value)
 		{
-			return value;
+			return{ Binder<LeftOperand, T1, T2>::Bind(exp.m_leftOperand, var, value), Binder<RightOperand, T1, T2>::Bind(exp.m_rightOperand, var, value) };
 		}
 	};
 
-	template <class T>
-	struct RadianReduction : RadianReductionBase<T, std::is_fundamental<T>::value>
+	template <int p, class T, class T1, typename T2>
+	struct Binder<PostfixExpression<Power<p>, T>, T1, T2>
 	{
+		typedef PostfixExpression<Power<p>, typename Binder<T, T1, T2>::type> type;
+		static inline type Bind(const PostfixExpression<Power<p>, T> & exp, const T1& var, const T2& value)
+		{
+			return{ Binder<T, T1, T2>::Bind(exp.m_operand, var, value) };
+		}
 	};
 
-	struct Sinus
+	template <class F, class T1, class T2, typename T3>
+	struct Binder<FunctionExpression<F, T1>, T2, T3>
 	{
-	public:
-		template <typename T>
-		auto operator()(const T && operand) const
+		typedef FunctionExpression<F, typename Binder<T1, T2, T3>::type> type;
+		static inline type Bind(const FunctionExpression<F, T1>& exp, const T2& var, const T3& value)
 		{
-			T oper = operand;
-			return Expander<
-				CONFIDENCE_LEVEL,
-				FunctionExpression<
-					Sinus,
-					typename RadianReduction<
-						T
-					>::type
-				>
-			>::Expand(
-				RadianReduction<
-					T
-				>::Get(oper)
-			)();
+			return{ Binder<T1, T2, T3>::Bind(exp.m_operand, var, value) };
 		}
+	};
 
-		operator std::string() const
+	template <class T1, class T2, typename T3>
+	struct Binder<Expression<T1>, T2, T3>
+	{
+		typedef typename Binder<T1, T2, T3>::type type;
+		static inline type Bind(const T1& exp, const T2& var, const T3& value)
 		{
-			return "sin";
+			return Binder<T1, T2, T3>::Bind(exp, var, value);
 		}
 	};
 
-	struct Cosinus
+	template <class T, typename V>
+	struct IncrementalNode
 	{
-	public:
-		template <typename T>
-		auto operator()(const T && operand) const
+		IncrementalNode(const T & expr)
+			: m_value((V)expr())
 		{
-			T oper = operand;
-			return Expander<
-				CONFIDENCE_LEVEL,
-				FunctionExpression<
-					Cosinus,
-					typename RadianReduction<
-						T
-					>::type
-				>
-			>::Expand(
-				RadianReduction<
-				T
-				>::Get(oper)
-			)();
 		}
 
-		operator std::string() const
+		void Set(char, const V &)
 		{
-			return "cos";
 		}
-	};
-
-	template <typename T>
-	static inline FunctionExpression<Sinus, typename ExpressionOperator<T>::type> sin(const T& operand)
-	{
-		return{ ExpressionOperator<T>::GetParam(operand) };
-	}
 
-	template <typename T>
-	static inline FunctionExpression<Cosinus, typename ExpressionOperator<T>::type> cos(const T& operand)
+		V m_value;
+	};
+	template <char id, typename V>
+	struct IncrementalNode<Variable<id>, V>
 	{
-		return{ ExpressionOperator<T>::GetParam(operand) };
-	}
+		IncrementalNode(const Variable<id> &)
+			: m_value(std::numeric_limits<V>::quiet_NaN())
+		{
+		}
 
-	template <size_t terms, class T>
-	struct Expander<terms, Expression<T>>
-	{
-		static inline auto Expand(const T & exp)
+		void Set(char var, const V & value)
 		{
-			return Expander<terms, T>::Get(exp());
+			if (var == id) m_value = value;
 		}
+
+		V m_value;
 	};
-	template <size_t terms, class T>
-	struct Expander<terms, FunctionExpression<Sinus, T>>
+	template <class Operator, class Operand, typename V>
+	struct IncrementalNode<UnaryExpression<Operator, Operand>, V>
 	{
-		static inline auto Expand(const FunctionExpression<Sinus, T> & exp)
+		IncrementalNode(const UnaryExpression<Operator, Operand> & expr)
+			: m_operand(expr.m_operand),
+			m_value(m_operation(V(m_operand.m_value)))
 		{
-			return TaylorSine<
-				terms,
-				typename TypeToFloat<
-					T
-				>::type
-			>::Get(
-				(typename TypeToFloat<T>::type)exp.m_operand
-			);
 		}
+
+		void Set(char var, const V & value)
+		{
+			if (!VariableListHas<typename Variables<Operand>::type>::Get(var)) return;
+			m_operand.Set(var, value);
+			m_value = (V)m_operation(V(m_operand.m_value));
+		}
+
+		Operator m_operation;
+		IncrementalNode<Operand, V> m_operand;
+		V m_value;
 	};
-	template <size_t terms, class T>
-	struct Expander<terms, FunctionExpression<Cosinus, T>>
+	template <class Operator, class Operand, typename V>
+	struct IncrementalNode<PostfixExpression<Operator, Operand>, V>
 	{
-		static inline auto Expand(const FunctionExpression<Cosinus, T> & exp)
+		IncrementalNode(const PostfixExpression<Operator, Operand> & expr)
+			: m_operand(expr.m_operand),
+			m_value(m_operation(V(m_operand.m_value)))
 		{
-			return TaylorCosine<
+		}
+
+		void Set(char var, const V & value)
+		{
+			if (!VariableListHas<typename Variables<Operand>::type>::Get(var)) return;
+			m_operand.Set(var, value);
+			m_value = (V)m_operation(V(m_operand.m_value));
+		}
+
+		Operator m_operation;
+		IncrementalNode<Operand, V> m_operand;
+		V m_value;
+	};
+	template <class Operator, class LeftOperand, class RightOperand, typename V>
+	struct IncrementalNode<BinarryExpression<Operator, LeftOperand, RightOperand>, V>
+	{
+		IncrementalNode(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
+			: m_leftOperand(expr.m_leftOperand),
+			m_rightOperand(expr.m_rightOperand),
+			m_value(m_operation(V(m_leftOperand.m_value), V(m_rightOperand.m_value)))
+		{
+		}
+
+		void Set(char var, const V & value)
+		{
+			bool left = VariableListHas<typename Variables<LeftOperand>::type>::Get(var);
+			bool right = VariableListHas<typename Variables<RightOperand>::type>::Get(var);
+			if (!left && !right) return;
+			if (left) m_leftOperand.Set(var, value);
+			if (right) m_rightOperand.Set(var, value);
+			m_value = (V)m_operation(V(m_leftOperand.m_value), V(m_rightOperand.m_value));
+		}
+
+		Operator m_operation;
+		IncrementalNode<LeftOperand, V> m_leftOperand;
+		IncrementalNode<RightOperand, V> m_rightOperand;
+		V m_value;
+	};
+	template <class F, class T, typename V>
+	struct IncrementalNode<FunctionExpression<F, T>, V>
+	{
+		IncrementalNode(const FunctionExpression<F, T> & expr)
+			: m_operand(expr.m_operand),
+			m_value(m_function(V(m_operand.m_value)))
+		{
+		}
+
+		void Set(char var, const V & value)
+		{
+			if (!VariableListHas<typename Variables<T>::type>::Get(var)) return;
+			m_operand.Set(var, value);
+			m_value = (V)m_function(V(m_operand.m_value));
+		}
+
+		F m_function;
+		IncrementalNode<T, V> m_operand;
+		V m_value;
+	};
+
+	template <class T, typename V = long double>
+	struct Incremental
+	{
+		Incremental(const T & expr)
+			: m_root(expr)
+		{
+		}
+
+		template <char id>
+		Incremental & set(const Variable<id> &, const V & value)
+		{
+			return set(id, value);
+		}
+
+		Incremental & set(char id, const V & value)
+		{
+			m_root.Set(id, value);
+			return *this;
+		}
+
+		V operator()() const
+		{
+			return m_root.m_value;
+		}
+
+		IncrementalNode<T, V> m_root;
+	};
+
+	template <typename V = long double, class T>
+	static inline Incremental<T, V> incremental(const Expression<T> & expr)
+	{
+		return{ expr() };
+	}
+
+	template <class L, char id>
+	struct VariableListIndex;
+	template <char head, char... tail, char id>
+	struct VariableListIndex<VariableList<head, tail...>, id>
+	{
+		static constexpr size_t value = head == id ? 0 : 1 + VariableListIndex<VariableList<tail...>, id>::value;
+	};
+	template <char id>
+	struct VariableListIndex<VariableList<>, id>
+	{
+		static constexpr size_t value = 0;
+	};
+
+	template <class L>
+	struct VariableListFind;
+	template <>
+	struct VariableListFind<VariableList<> >
+	{
+		static constexpr int Get(char, int = 0)
+		{
+			return -1;
+		}
+	};
+	template <char head, char... tail>
+	struct VariableListFind<VariableList<head, tail...> >
+	{
+		static constexpr int Get(char id, int index = 0)
+		{
+			return head == id ? index : VariableListFind<VariableList<tail...> >::Get(id, index + 1);
+		}
+	};
+
+	template <class L, typename V = long double>
+	struct Environment
+	{
+		typedef V value_type;
+
+		Environment()
+		{
+			for (auto & value : m_values) value = std::numeric_limits<V>::quiet_NaN();
+		}
+
+		template <char id>
+		const V & Get() const
+		{
+			static_assert(VariableListContains<L, id>::value, "variable is not part of the environment");
+			return m_values[VariableListIndex<L, id>::value];
+		}
+
+		template <char id>
+		Environment & Set(const Variable<id> &, const V & value)
+		{
+			static_assert(VariableListContains<L, id>::value, "variable is not part of the environment");
+			m_values[VariableListIndex<L, id>::value] = value;
+			return *this;
+		}
+
+		bool Set(char id, const V & value)
+		{
+			int index = VariableListFind<L>::Get(id);
+			if (index < 0) return false;
+			m_values[index] = value;
+			return true;
+		}
+
+		bool Find(char id, long double & value) const
+		{
+			int index = VariableListFind<L>::Get(id);
+			if (index < 0 || m_values[index] != m_values[index]) return false;
+			value = (long double)m_values[index];
+			return true;
+		}
+
+		V m_values[L::size ? L::size : 1];
+	};
+
+	template <typename V, typename T, bool arithmetic = std::is_arithmetic<T>::value>
+	struct PrecisionCast
+	{
+		static inline T Get(const T & value)
+		{
+			return value;
+		}
+	};
+	template <typename V, typename T>
+	struct PrecisionCast<V, T, true>
+	{
+		static inline V Get(const T & value)
+		{
+			return (V)value;
+		}
+	};
+
+	template <class T>
+	struct Evaluator
+	{
+		template <class E>
+		static inline auto Get(const T & expr, const E &)
+		{
+			return PrecisionCast<typename E::value_type, typename std::decay<decltype(expr())>::type>::Get(expr());
+		}
+	};
+	template <class T>
+	struct Evaluator<Expression<T> > : Evaluator<T>
+	{
+	};
+	template <char id>
+	struct Evaluator<Variable<id> >
+	{
+		template <class E>
+		static inline auto Get(const Variable<id> &, const E & env)
+		{
+			return env.template Get<id>();
+		}
+	};
+	template <class Operator, class Operand>
+	struct Evaluator<UnaryExpression<Operator, Operand> >
+	{
+		template <class E>
+		static inline auto Get(const UnaryExpression<Operator, Operand> & expr, const E & env)
+		{
+			return expr.m_operation(Evaluator<Operand>::Get(expr.m_operand, env));
+		}
+	};
+	template <class Operator, class Operand>
+	struct Evaluator<PostfixExpression<Operator, Operand> >
+	{
+		template <class E>
+		static inline auto Get(const PostfixExpression<Operator, Operand> & expr, const E & env)
+		{
+			return expr.m_operation(Evaluator<Operand>::Get(expr.m_operand, env));
+		}
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct Evaluator<BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		template <class E>
+		static inline auto Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr, const E & env)
+		{
+			return expr.m_operation(Evaluator<LeftOperand>::Get(expr.m_leftOperand, env), Evaluator<RightOperand>::Get(expr.m_rightOperand, env));
+		}
+	};
+	template <class F, class T>
+	struct Evaluator<FunctionExpression<F, T> >
+	{
+		template <class E>
+		static inline auto Get(const FunctionExpression<F, T> & expr, const E & env)
+		{
+			return expr.m_function(Evaluator<T>::Get(expr.m_operand, env));
+		}
+	};
+
+	template <class T, class E>
+	static inline auto evaluate(const Expression<T> & expr, const E & env)
+	{
+		return Evaluator<T>::Get(expr(), env);
+	}
+
+	static inline size_t HashCombine(size_t seed, size_t value);
+
+	// Unset (NaN) values hash and compare alike.
+	template <class L, typename V>
+	static inline size_t EnvironmentHash(size_t seed, const Environment<L, V> & env)
+	{
+		for (const V & value : env.m_values) seed = HashCombine(seed, value != value ? 0 : std::hash<V>()(value));
+		return seed;
+	}
+
+	template <class L, typename V>
+	static inline bool EnvironmentEqual(const Environment<L, V> & lhs, const Environment<L, V> & rhs)
+	{
+		for (size_t i = 0; i < sizeof(lhs.m_values) / sizeof(V); ++i)
+		{
+			if (lhs.m_values[i] != rhs.m_values[i] && (lhs.m_values[i] == lhs.m_values[i] || rhs.m_values[i] == rhs.m_values[i])) return false;
+		}
+		return true;
+	}
+
+	// Erases the type of an environment down to a lookup by variable id.
+	// Variables the environment leaves unset (NaN) report as not found.
+	struct AnyEnvironment
+	{
+		template <class E>
+		AnyEnvironment(const E & env)
+			: m_env(&env),
+			m_find([](const void * env, char id, long double & value) { return static_cast<const E *>(env)->Find(id, value); })
+		{
+		}
+
+		bool Find(char id, long double & value) const
+		{
+			return m_find(m_env, id, value);
+		}
+
+		const void * m_env;
+		bool(*m_find)(const void *, char, long double &);
+	};
+
+	template <class L>
+	struct AnyEnvironmentLoader;
+	template <char... ids>
+	struct AnyEnvironmentLoader<VariableList<ids...> >
+	{
+		template <class E>
+		static inline void Load(E & target, const AnyEnvironment & source)
+		{
+			const char list[] = { ids..., 0 };
+			long double value;
+			for (size_t i = 0; i < sizeof...(ids); ++i)
+			{
+				if (source.Find(list[i], value)) target.Set(list[i], value);
+			}
+		}
+	};
+
+	template <class T>
+	struct AnyExpressionHolder
+	{
+		AnyExpressionHolder(const T & expr)
+			: m_expr(expr)
+		{
+		}
+
+		long double operator()() const
+		{
+			return (long double)Evaluator<T>::Get(m_expr, m_environment);
+		}
+
+		long double operator()(const AnyEnvironment & env) const
+		{
+			Environment<typename Variables<T>::type, long double> environment(m_environment);
+			AnyEnvironmentLoader<typename Variables<T>::type>::Load(environment, env);
+			return (long double)Evaluator<T>::Get(m_expr, environment);
+		}
+
+		T m_expr;
+		Environment<typename Variables<T>::type, long double> m_environment;
+	};
+
+	struct AnyExpressionTable
+	{
+		long double(*evaluate)(const void *);
+		long double(*substitute)(const void *, const AnyEnvironment &);
+		bool(*bind)(void *, char, long double);
+		std::string(*string)(const void *);
+		size_t(*hash)(const void *);
+		bool(*equal)(const void *, const void *);
+		void(*copy)(const void *, void *);
+		void(*move)(void *, void *);
+		void(*destroy)(void *);
+	};
+
+	template <class H, bool local>
+	struct AnyExpressionStorage
+	{
+		static inline H * Get(void * storage)
+		{
+			return static_cast<H *>(storage);
+		}
+		static inline const H * Get(const void * storage)
+		{
+			return static_cast<const H *>(storage);
+		}
+		static inline void Create(void * storage, const H & holder)
+		{
+			new (storage) H(holder);
+		}
+		static inline void Move(void * from, void * to)
+		{
+			new (to) H(std::move(*Get(from)));
+			Get(from)->~H();
+		}
+		static inline void Destroy(void * storage)
+		{
+			Get(storage)->~H();
+		}
+	};
+	template <class H>
+	struct AnyExpressionStorage<H, false>
+	{
+		static inline H * Get(void * storage)
+		{
+			return *static_cast<H **>(storage);
+		}
+		static inline const H * Get(const void * storage)
+		{
+			return *static_cast<H * const *>(storage);
+		}
+		static inline void Create(void * storage, const H & holder)
+		{
+			*static_cast<H **>(storage) = new H(holder);
+		}
+		static inline void Move(void * from, void * to)
+		{
+			*static_cast<H **>(to) = Get(from);
+		}
+		static inline void Destroy(void * storage)
+		{
+			delete Get(storage);
+		}
+	};
+
+	struct AnyExpression : Expression<AnyExpression>
+	{
+		static constexpr size_t capacity = 128;
+
+		AnyExpression()
+			: m_table(nullptr)
+		{
+		}
+
+		template <class T, class = typename std::enable_if<!std::is_same<T, AnyExpression>::value>::type>
+		AnyExpression(const Expression<T> & expr)
+			: m_table(&Table<T>())
+		{
+			Storage<T>::Create(&m_storage, AnyExpressionHolder<T>(expr()));
+		}
+
+		AnyExpression(const AnyExpression & expr)
+			: m_table(expr.m_table)
+		{
+			if (m_table) m_table->copy(&expr.m_storage, &m_storage);
+		}
+
+		AnyExpression(AnyExpression && expr) noexcept
+			: m_table(expr.m_table)
+		{
+			if (m_table) m_table->move(&expr.m_storage, &m_storage);
+			expr.m_table = nullptr;
+		}
+
+		~AnyExpression()
+		{
+			if (m_table) m_table->destroy(&m_storage);
+		}
+
+		AnyExpression & operator=(const AnyExpression & expr)
+		{
+			if (this != &expr)
+			{
+				AnyExpression copy(expr);
+				*this = std::move(copy);
+			}
+			return *this;
+		}
+
+		AnyExpression & operator=(AnyExpression && expr) noexcept
+		{
+			if (this != &expr)
+			{
+				if (m_table) m_table->destroy(&m_storage);
+				m_table = expr.m_table;
+				if (m_table) m_table->move(&expr.m_storage, &m_storage);
+				expr.m_table = nullptr;
+			}
+			return *this;
+		}
+
+		long double operator()() const
+		{
+			return m_table ? m_table->evaluate(&m_storage) : std::numeric_limits<long double>::quiet_NaN();
+		}
+
+		// Values found in env take precedence over values given to bind().
+		long double operator()(const AnyEnvironment & env) const
+		{
+			return m_table ? m_table->substitute(&m_storage, env) : std::numeric_limits<long double>::quiet_NaN();
+		}
+
+		// Prints the held tree as it was erased; bound values are not substituted.
+		operator std::string() const
+		{
+			return m_table ? m_table->string(&m_storage) : std::string();
+		}
+
+		// Binds into the environment of the holder, not into the held tree.
+		AnyExpression bind(char id, long double value) const
+		{
+			AnyExpression result(*this);
+			if (result.m_table) result.m_table->bind(&result.m_storage, id, value);
+			return result;
+		}
+
+		bool empty() const
+		{
+			return m_table == nullptr;
+		}
+
+		size_t hash() const
+		{
+			return m_table ? m_table->hash(&m_storage) : 0;
+		}
+
+		// Holders of different types never compare equal.
+		bool equal(const AnyExpression & expr) const
+		{
+			if (m_table != expr.m_table) return false;
+			return !m_table || m_table->equal(&m_storage, &expr.m_storage);
+		}
+
+	private:
+		template <class T>
+		struct Storage : AnyExpressionStorage<
+			AnyExpressionHolder<T>,
+			sizeof(AnyExpressionHolder<T>) <= capacity &&
+			alignof(AnyExpressionHolder<T>) <= alignof(std::max_align_t) &&
+			std::is_nothrow_move_constructible<AnyExpressionHolder<T> >::value
+		>
+		{
+		};
+
+		template <class T>
+		static const AnyExpressionTable & Table()
+		{
+			static const AnyExpressionTable table =
+			{
+				[](const void * storage) -> long double
+				{
+					return (*Storage<T>::Get(storage))();
+				},
+				[](const void * storage, const AnyEnvironment & env) -> long double
+				{
+					return (*Storage<T>::Get(storage))(env);
+				},
+				[](void * storage, char id, long double value) -> bool
+				{
+					return Storage<T>::Get(storage)->m_environment.Set(id, value);
+				},
+				[](const void * storage) -> std::string
+				{
+					return (std::string)Storage<T>::Get(storage)->m_expr;
+				},
+				[](const void * storage) -> size_t
+				{
+					const AnyExpressionHolder<T> & holder = *Storage<T>::Get(storage);
+					return EnvironmentHash(Hasher<T>::Get(holder.m_expr), holder.m_environment);
+				},
+				[](const void * lhs, const void * rhs) -> bool
+				{
+					const AnyExpressionHolder<T> & left = *Storage<T>::Get(lhs);
+					const AnyExpressionHolder<T> & right = *Storage<T>::Get(rhs);
+					return EnvironmentEqual(left.m_environment, right.m_environment) && Equality<T, T>::Get(left.m_expr, right.m_expr);
+				},
+				[](const void * from, void * to)
+				{
+					Storage<T>::Create(to, *Storage<T>::Get(from));
+				},
+				[](void * from, void * to)
+				{
+					Storage<T>::Move(from, to);
+				},
+				[](void * storage)
+				{
+					Storage<T>::Destroy(storage);
+				}
+			};
+			return table;
+		}
+
+		const AnyExpressionTable * m_table;
+		typename std::aligned_storage<capacity, alignof(std::max_align_t)>::type m_storage;
+	};
+
+	template <char id, typename T>
+	struct Binder<AnyExpression, Variable<id>, T>
+	{
+		typedef AnyExpression type;
+		static inline type Bind(const AnyExpression & exp, const Variable<id> &, const T & value)
+		{
+			return exp.bind(id, (long double)value());
+		}
+	};
+
+	template <>
+	struct Evaluator<AnyExpression>
+	{
+		template <class E>
+		static inline typename E::value_type Get(const AnyExpression & expr, const E & env)
+		{
+			return (typename E::value_type)expr(AnyEnvironment(env));
+		}
+	};
+
+	template <>
+	struct HasVariables<AnyExpression>
+	{
+		static constexpr bool value = true;
+	};
+
+	// The held tree is erased, so assume it may use any of the predefined variables.
+	template <>
+	struct Variables<AnyExpression>
+	{
+		typedef VariableList<'a', 'b', 'c', 'd', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'> type;
+	};
+
+	template <>
+	struct StagerBase<AnyExpression, true>
+	{
+		typedef AnyExpression type;
+		static inline type Stage(const AnyExpression & expr)
+		{
+			return expr;
+		}
+	};
+
+	template <typename V>
+	struct IncrementalNode<AnyExpression, V>
+	{
+		IncrementalNode(const AnyExpression & expr)
+			: m_expr(expr),
+			m_value((V)m_expr())
+		{
+		}
+
+		void Set(char var, const V & value)
+		{
+			m_expr = m_expr.bind(var, (long double)value);
+			m_value = (V)m_expr();
+		}
+
+		AnyExpression m_expr;
+		V m_value;
+	};
+
+	template <class T, typename V = long double>
+	struct BindView : Expression<BindView<T, V> >
+	{
+		BindView(const T & expr)
+			: m_expr(expr)
+		{
+		}
+
+		template <char id, typename T1>
+		BindView bind(const Variable<id> &, const T1 & value) const
+		{
+			BindView view(*this);
+			view.m_environment.Set(id, (V)ExpressionOperator<T1>::GetParam(value)());
+			return view;
+		}
+
+		V operator()() const
+		{
+			return (V)Evaluator<T>::Get(m_expr, m_environment);
+		}
+
+		operator std::string() const
+		{
+			return (std::string)m_expr;
+		}
+
+		const T & m_expr;
+		Environment<typename Variables<T>::type, V> m_environment;
+	};
+
+	template <char id, class T, typename V, typename T1>
+	struct Binder<BindView<T, V>, Variable<id>, T1>
+	{
+		typedef BindView<T, V> type;
+		static inline type Bind(const BindView<T, V> & exp, const Variable<id> & var, const T1 & value)
+		{
+			return exp.bind(var, value);
+		}
+	};
+
+	template <class T, char id, typename T1>
+	static inline BindView<T, typename FloatType<T1>::type> bind_view(const Expression<T> & expr, const Variable<id> & var, const T1 & value)
+	{
+		return BindView<T, typename FloatType<T1>::type>(expr()).bind(var, value);
+	}
+
+	// The view keeps a reference to the tree, so binding a temporary would leave it dangling.
+	template <class T, char id, typename T1>
+	static inline void bind_view(const Expression<T> && expr, const Variable<id> & var, const T1 & value) = delete;
+
+	template <size_t terms, typename T>
+	struct TaylorSineTerm
+	{
+		static inline auto Get(const T & x)
+		{
+			return (power<terms>(-1) / (typename FloatType<T>::type)factorial<(2 * terms) + 1>()) * power<(2 * terms) + 1>(x);
+		}
+	};
+	template<size_t terms, typename T>
+	struct TaylorSine
+	{
+		static inline auto Get(const T & x)
+		{
+			return TaylorSineTerm<terms, T>::Get(x) + TaylorSine<terms - 1, T>::Get(x);
+		}
+	};
+	template <typename T>
+	struct TaylorSine<0, T>
+	{
+		static inline auto Get(const T & x)
+		{
+			return TaylorSineTerm<0, T>::Get(x);
+		}
+	};
+
+	template <size_t terms, typename T>
+	struct TaylorCosineTerm
+	{
+		static inline auto Get(const T & x)
+		{
+			return (power<terms>(-1) / (typename FloatType<T>::type)factorial<(2 * terms)>()) * power<(2 * terms)>(x);
+		}
+	};
+	template<size_t terms, typename T>
+	struct TaylorCosine
+	{
+		static inline auto Get(const T & x)
+		{
+			return TaylorCosineTerm<terms, T>::Get(x) + TaylorCosine<terms - 1, T>::Get(x);
+		}
+	};
+	template <typename T>
+	struct TaylorCosine<0, T>
+	{
+		static inline auto Get(const T & x)
+		{
+			return TaylorCosineTerm<0, T>::Get(x);
+		}
+	};
+
+	template <size_t terms, typename T>
+	struct TaylorETerm
+	{
+		static inline auto Get(const T & x)
+		{
+			return power<terms>(x) / (typename FloatType<T>::type)factorial<terms>();
+		}
+	};
+	template<size_t terms, typename T>
+	struct TaylorE
+	{
+		static inline auto Get(const T & x)
+		{
+			return TaylorETerm<terms, T>::Get(x) + TaylorE<terms - 1, T>::Get(x);
+		}
+	};
+	template <typename T>
+	struct TaylorE<0, T>
+	{
+		static inline auto Get(const T & x)
+		{
+			return TaylorETerm<0, T>::Get(x);
+		}
+	};
+
+	template <typename T, bool fund>
+	struct TypeToFloatBase
+	{
+		typedef T type;
+	};
+	template <typename T>
+	struct TypeToFloatBase<T, true>
+	{
+		typedef typename FloatType<T>::type type;
+	};
+
+	template <typename T>
+	struct TypeToFloat : TypeToFloatBase<T, std::is_fundamental<T>::value>
+	{
+	};
+
+	template <size_t terms, typename T>
+	struct TaylorLnTerm
+	{
+		static inline auto Get(const T & x)
+		{
+			return 2 * (power<(2*terms)-1>((x-1)/(x+1)) / ((2 * terms) - 1));
+		}
+	};
+	template<size_t terms, typename T>
+	struct TaylorLn
+	{
+		static inline auto Get(const T & x)
+		{
+			return TaylorLnTerm<terms, T>::Get(x) + TaylorLn<terms - 1, T>::Get(x);
+		}
+	};
+	template <typename T>
+	struct TaylorLn<1, T>
+	{
+		static inline auto Get(const T & x)
+		{
+			return TaylorLnTerm<1, T>::Get(x);
+		}
+	};
+
+	template <typename T>
+	static inline auto ln(const T & value)
+	{
+		return TaylorLn<
+			CONFIDENCE_LEVEL,
+			typename TypeToFloat<T>::type
+		>::Get((typename TypeToFloat<T>::type)value);
+	}
+
+	template <class T, bool numeric>
+	struct RadianReductionBase
+	{
+		typedef typename FloatType<T>::type type;
+		static inline type Get(type value)
+		{
+			if (value > _pi())
+			{
+				value -= _2pi();
+				return Get(value);
+			}
+			else if (value < -_pi())
+			{
+				value += _2pi();
+				return Get(value);
+			}
+			else return value;
+		}
+	};
+	template <class T>
+	struct RadianReductionBase<T, false>
+	{
+		typedef T type;
+		static inline type Get(type & value)
+		{
+			return value;
+		}
+	};
+
+	template <class T>
+	struct RadianReduction : RadianReductionBase<T, std::is_fundamental<T>::value>
+	{
+	};
+
+	struct Sinus
+	{
+	public:
+		template <typename T>
+		auto operator()(T && operand) const
+		{
+			typedef typename std::decay<T>::type type;
+			type oper = std::forward<T>(operand);
+			return Expander<
+				CONFIDENCE_LEVEL,
+				FunctionExpression<
+					Sinus,
+					typename RadianReduction<
+						type
+					>::type
+				>
+			>::Expand(
+				RadianReduction<
+					type
+				>::Get(oper)
+			)();
+		}
+
+		operator std::string() const
+		{
+			return "sin";
+		}
+	};
+
+	struct Cosinus
+	{
+	public:
+		template <typename T>
+		auto operator()(T && operand) const
+		{
+			typedef typename std::decay<T>::type type;
+			type oper = std::forward<T>(operand);
+			return Expander<
+				CONFIDENCE_LEVEL,
+				FunctionExpression<
+					Cosinus,
+					typename RadianReduction<
+						type
+					>::type
+				>
+			>::Expand(
+				RadianReduction<
+				type
+				>::Get(oper)
+			)();
+		}
+
+		operator std::string() const
+		{
+			return "cos";
+		}
+	};
+
+	template <typename T>
+	static inline FunctionExpression<Sinus, typename ExpressionOperator<T>::type> sin(const T& operand)
+	{
+		return{ ExpressionOperator<T>::GetParam(operand) };
+	}
+
+	template <typename T>
+	static inline FunctionExpression<Cosinus, typename ExpressionOperator<T>::type> cos(const T& operand)
+	{
+		return{ ExpressionOperator<T>::GetParam(operand) };
+	}
+
+	template <size_t terms>
+	struct SineCosine
+	{
+		template <typename T>
+		static inline std::pair<typename FloatType<T>::type, typename FloatType<T>::type> Get(T value)
+		{
+			typedef typename FloatType<T>::type type;
+			type x = RadianReduction<type>::Get((type)value);
+			type square = x * x;
+			type power = 1;
+			type factorial = 1;
+			type sine = 0;
+			type cosine = 0;
+			for (size_t k = 0; k <= terms; ++k)
+			{
+				type sign = k % 2 ? -1 : 1;
+				cosine += (sign / factorial) * power;
+				factorial *= (type)(2 * k + 1);
+				sine += (sign / factorial) * (power * x);
+				factorial *= (type)(2 * k + 2);
+				power *= square;
+			}
+			return{ sine, cosine };
+		}
+	};
+
+	// sin(u) and cos(u) over one operand share a single sincos call. The DAG evaluators (NodeEvaluator,
+	// ExpressionImage, evaluate_many, MultiExpression) pair them through the hash-consed operand node.
+	// Static trees are paired once by fuse(), which lim applies to every tree it evaluates.
+	template <typename T>
+	static inline auto sincos(const T & value)
+	{
+		return SineCosine<CONFIDENCE_LEVEL>::Get(value);
+	}
+
+	template <class T, bool variables>
+	struct SineCosineValue;
+
+	// sin or cos that reads its value from the enclosing SineCosineLet when its operand equals the
+	// shared one. m_shared is decided once by fuse(), so evaluation never compares operands.
+	template <class F, class U>
+	struct SharedFunction : Expression<SharedFunction<F, U> >
+	{
+		SharedFunction(U operand, bool shared)
+			: m_operand(std::move(operand)),
+			m_shared(shared)
+		{
+		}
+
+		auto operator()() const
+		{
+			return F()(m_operand());
+		}
+
+		U m_operand;
+		bool m_shared;
+	};
+
+	// Evaluates sincos(m_operand) once and makes both values visible to the SharedFunction nodes of m_body.
+	template <class U, class Body>
+	struct SineCosineLet : Expression<SineCosineLet<U, Body> >
+	{
+		SineCosineLet(U operand, Body body)
+			: m_operand(std::move(operand)),
+			m_body(std::move(body))
+		{
+		}
+
+		auto operator()() const
+		{
+			return SineCosineValue<SineCosineLet, HasVariables<U>::value || HasVariables<Body>::value>::Get(*this);
+		}
+
+		U m_operand;
+		Body m_body;
+	};
+
+	template <class F, class U>
+	struct HasVariables<SharedFunction<F, U> >
+	{
+		static constexpr bool value = HasVariables<U>::value;
+	};
+	template <class U, class Body>
+	struct HasVariables<SineCosineLet<U, Body> >
+	{
+		static constexpr bool value = HasVariables<U>::value || HasVariables<Body>::value;
+	};
+
+	template <class F, class U>
+	struct Variables<SharedFunction<F, U> >
+	{
+		typedef typename Variables<U>::type type;
+	};
+	template <class U, class Body>
+	struct Variables<SineCosineLet<U, Body> >
+	{
+		typedef typename VariableListUnion<typename Variables<U>::type, typename Variables<Body>::type>::type type;
+	};
+
+	template <class F, class U, class T2, typename T3>
+	struct Binder<SharedFunction<F, U>, T2, T3>
+	{
+		typedef SharedFunction<F, typename Binder<U, T2, T3>::type> type;
+		static inline type Bind(const SharedFunction<F, U> & exp, const T2 & var, const T3 & value)
+		{
+			return{ Binder<U, T2, T3>::Bind(exp.m_operand, var, value), exp.m_shared };
+		}
+	};
+	template <class U, class Body, class T2, typename T3>
+	struct Binder<SineCosineLet<U, Body>, T2, T3>
+	{
+		typedef SineCosineLet<typename Binder<U, T2, T3>::type, typename Binder<Body, T2, T3>::type> type;
+		static inline type Bind(const SineCosineLet<U, Body> & exp, const T2 & var, const T3 & value)
+		{
+			return{ Binder<U, T2, T3>::Bind(exp.m_operand, var, value), Binder<Body, T2, T3>::Bind(exp.m_body, var, value) };
+		}
+	};
+
+	// Environment seen by the body of a SineCosineLet; the shared pair is looked up by operand type.
+	template <class U, class E, typename S>
+	struct SineCosineEnvironment
+	{
+		typedef typename E::value_type value_type;
+
+		template <char id>
+		decltype(auto) Get() const
+		{
+			return m_env.template Get<id>();
+		}
+
+		bool Find(char id, long double & value) const
+		{
+			return m_env.Find(id, value);
+		}
+
+		const std::pair<S, S> & Shared(const U *) const
+		{
+			return m_values;
+		}
+
+		template <class W>
+		decltype(auto) Shared(const W * operand) const
+		{
+			return m_env.Shared(operand);
+		}
+
+		operator const E &() const
+		{
+			return m_env;
+		}
+
+		const E & m_env;
+		std::pair<S, S> m_values;
+	};
+
+	template <class F>
+	struct SharedFunctionIndex;
+	template <>
+	struct SharedFunctionIndex<Sinus>
+	{
+		static constexpr size_t value = 0;
+	};
+	template <>
+	struct SharedFunctionIndex<Cosinus>
+	{
+		static constexpr size_t value = 1;
+	};
+
+	template <class F, class U>
+	struct Evaluator<SharedFunction<F, U> >
+	{
+		template <class E>
+		static inline auto Get(const SharedFunction<F, U> & expr, const E & env)
+		{
+			typedef typename FloatType<typename std::decay<decltype(Evaluator<U>::Get(expr.m_operand, env))>::type>::type type;
+			if (expr.m_shared) return (type)std::get<SharedFunctionIndex<F>::value>(env.Shared((const U *)nullptr));
+			return (type)F()(Evaluator<U>::Get(expr.m_operand, env));
+		}
+	};
+	template <class U, class Body>
+	struct Evaluator<SineCosineLet<U, Body> >
+	{
+		template <class E>
+		static inline auto Get(const SineCosineLet<U, Body> & expr, const E & env)
+		{
+			auto values = sincos(Evaluator<U>::Get(expr.m_operand, env));
+			SineCosineEnvironment<U, E, typename decltype(values)::first_type> inner{ env, values };
+			return Evaluator<Body>::Get(expr.m_body, inner);
+		}
+	};
+
+	template <class T, bool variables>
+	struct SineCosineValue
+	{
+		static inline auto Get(const T & expr)
+		{
+			return expr.m_body();
+		}
+	};
+	template <class T>
+	struct SineCosineValue<T, false>
+	{
+		static inline auto Get(const T & expr)
+		{
+			return Evaluator<T>::Get(expr, Environment<VariableList<>, long double>());
+		}
+	};
+
+	template <class... Ts>
+	struct SineCosineList
+	{
+	};
+
+	template <class L1, class L2>
+	struct SineCosineConcat;
+	template <class... T1s, class... T2s>
+	struct SineCosineConcat<SineCosineList<T1s...>, SineCosineList<T2s...> >
+	{
+		typedef SineCosineList<T1s..., T2s...> type;
+	};
+
+	template <class L, class U>
+	struct SineCosineContains;
+	template <class U>
+	struct SineCosineContains<SineCosineList<>, U>
+	{
+		static constexpr bool value = false;
+	};
+	template <class Head, class... Tail, class U>
+	struct SineCosineContains<SineCosineList<Head, Tail...>, U>
+	{
+		static constexpr bool value = std::is_same<Head, U>::value || SineCosineContains<SineCosineList<Tail...>, U>::value;
+	};
+
+	// Operand types of every F node reachable without entering another pairing.
+	template <class F, class T>
+	struct SineCosineOperands
+	{
+		typedef SineCosineList<> type;
+	};
+	template <class F, class Operator, class Operand>
+	struct SineCosineOperands<F, UnaryExpression<Operator, Operand> > : SineCosineOperands<F, Operand>
+	{
+	};
+	template <class F, class Operator, class Operand>
+	struct SineCosineOperands<F, PostfixExpression<Operator, Operand> > : SineCosineOperands<F, Operand>
+	{
+	};
+	template <class F, class Operator, class LeftOperand, class RightOperand>
+	struct SineCosineOperands<F, BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		typedef typename SineCosineConcat<typename SineCosineOperands<F, LeftOperand>::type, typename SineCosineOperands<F, RightOperand>::type>::type type;
+	};
+	template <class F, class G, class T>
+	struct SineCosineOperands<F, FunctionExpression<G, T> >
+	{
+		typedef typename SineCosineConcat<
+			typename std::conditional<std::is_same<F, G>::value, SineCosineList<T>, SineCosineList<> >::type,
+			typename SineCosineOperands<F, T>::type
+		>::type type;
+	};
+
+	// First sine operand type that also has a cosine, or void.
+	template <class Sines, class Cosines>
+	struct SineCosineShared
+	{
+		typedef void type;
+	};
+	template <class Head, class... Tail, class Cosines>
+	struct SineCosineShared<SineCosineList<Head, Tail...>, Cosines>
+	{
+		typedef typename std::conditional<
+			SineCosineContains<Cosines, Head>::value,
+			Head,
+			typename SineCosineShared<SineCosineList<Tail...>, Cosines>::type
+		>::type type;
+	};
+
+	// Replaces sin(U) and cos(U) with SharedFunction nodes, marking those whose operand equals the shared one.
+	template <class T, class U>
+	struct SineCosineRewriter
+	{
+		typedef T type;
+		static inline void Find(const T &, const U *&)
+		{
+		}
+		static inline type Rewrite(const T & expr, const U &)
+		{
+			return expr;
+		}
+	};
+	template <class Operator, class Operand, class U>
+	struct SineCosineRewriter<UnaryExpression<Operator, Operand>, U>
+	{
+		typedef UnaryExpression<Operator, typename SineCosineRewriter<Operand, U>::type> type;
+		static inline void Find(const UnaryExpression<Operator, Operand> & expr, const U *& operand)
+		{
+			SineCosineRewriter<Operand, U>::Find(expr.m_operand, operand);
+		}
+		static inline type Rewrite(const UnaryExpression<Operator, Operand> & expr, const U & operand)
+		{
+			return type(SineCosineRewriter<Operand, U>::Rewrite(expr.m_operand, operand));
+		}
+	};
+	template <class Operator, class Operand, class U>
+	struct SineCosineRewriter<PostfixExpression<Operator, Operand>, U>
+	{
+		typedef PostfixExpression<Operator, typename SineCosineRewriter<Operand, U>::type> type;
+		static inline void Find(const PostfixExpression<Operator, Operand> & expr, const U *& operand)
+		{
+			SineCosineRewriter<Operand, U>::Find(expr.m_operand, operand);
+		}
+		static inline type Rewrite(const PostfixExpression<Operator, Operand> & expr, const U & operand)
+		{
+			return type(SineCosineRewriter<Operand, U>::Rewrite(expr.m_operand, operand));
+		}
+	};
+	template <class Operator, class LeftOperand, class RightOperand, class U>
+	struct SineCosineRewriter<BinarryExpression<Operator, LeftOperand, RightOperand>, U>
+	{
+		typedef BinarryExpression<Operator, typename SineCosineRewriter<LeftOperand, U>::type, typename SineCosineRewriter<RightOperand, U>::type> type;
+		static inline void Find(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr, const U *& operand)
+		{
+			SineCosineRewriter<LeftOperand, U>::Find(expr.m_leftOperand, operand);
+			SineCosineRewriter<RightOperand, U>::Find(expr.m_rightOperand, operand);
+		}
+		static inline type Rewrite(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr, const U & operand)
+		{
+			return type(SineCosineRewriter<LeftOperand, U>::Rewrite(expr.m_leftOperand, operand), SineCosineRewriter<RightOperand, U>::Rewrite(expr.m_rightOperand, operand));
+		}
+	};
+	template <class F, class T, class U>
+	struct SineCosineRewriter<FunctionExpression<F, T>, U>
+	{
+		typedef FunctionExpression<F, typename SineCosineRewriter<T, U>::type> type;
+		static inline void Find(const FunctionExpression<F, T> & expr, const U *& operand)
+		{
+			SineCosineRewriter<T, U>::Find(expr.m_operand, operand);
+		}
+		static inline type Rewrite(const FunctionExpression<F, T> & expr, const U & operand)
+		{
+			return type(SineCosineRewriter<T, U>::Rewrite(expr.m_operand, operand));
+		}
+	};
+	template <class F, class U>
+	struct SineCosineSlot
+	{
+		typedef SharedFunction<F, U> type;
+		static inline void Find(const FunctionExpression<F, U> & expr, const U *& operand)
+		{
+			if (!operand) operand = &expr.m_operand;
+		}
+		static inline type Rewrite(const FunctionExpression<F, U> & expr, const U & operand)
+		{
+			return{ expr.m_operand, Equality<U, U>::Get(expr.m_operand, operand) };
+		}
+	};
+	template <class U>
+	struct SineCosineRewriter<FunctionExpression<Sinus, U>, U> : SineCosineSlot<Sinus, U>
+	{
+	};
+	template <class U>
+	struct SineCosineRewriter<FunctionExpression<Cosinus, U>, U> : SineCosineSlot<Cosinus, U>
+	{
+	};
+
+	template <class T, class U = typename SineCosineShared<typename SineCosineOperands<Sinus, T>::type, typename SineCosineOperands<Cosinus, T>::type>::type>
+	struct SineCosineFuser
+	{
+		typedef SineCosineFuser<typename SineCosineRewriter<T, U>::type> body;
+		typedef SineCosineLet<U, typename body::type> type;
+		static inline type Fuse(const T & expr)
+		{
+			const U * operand = nullptr;
+			SineCosineRewriter<T, U>::Find(expr, operand);
+			return{ *operand, body::Fuse(SineCosineRewriter<T, U>::Rewrite(expr, *operand)) };
+		}
+	};
+	template <class T>
+	struct SineCosineFuser<T, void>
+	{
+		typedef T type;
+		static inline type Fuse(const T & expr)
+		{
+			return expr;
+		}
+	};
+
+	// Pairs every sin(u) with a cos(u) over an equal operand so that evaluate() computes both with
+	// one sincos call. The result evaluates like the original tree; fuse once, evaluate many times.
+	template <class T>
+	static inline typename SineCosineFuser<T>::type fuse(const Expression<T> & expr)
+	{
+		return SineCosineFuser<T>::Fuse(expr());
+	}
+
+	struct SquareRoot
+	{
+	public:
+		template <typename T>
+		static inline auto Value(const T & operand)
+		{
+			return std::sqrt((typename FloatType<T>::type)operand);
+		}
+
+		template <typename T>
+		auto operator()(T && operand) const
+		{
+			return FunctionValue<SquareRoot, typename std::decay<T>::type>::Get(operand);
+		}
+
+		operator std::string() const
+		{
+			return "sqrt";
+		}
+	};
+
+	struct Logarithm
+	{
+	public:
+		template <typename T>
+		static inline auto Value(const T & operand)
+		{
+			return std::log((typename FloatType<T>::type)operand);
+		}
+
+		template <typename T>
+		auto operator()(T && operand) const
+		{
+			return FunctionValue<Logarithm, typename std::decay<T>::type>::Get(operand);
+		}
+
+		operator std::string() const
+		{
+			return "log";
+		}
+	};
+
+	struct RealPower
+	{
+	public:
+		template <typename T1, typename T2>
+		static inline auto Value(const T1 & lhs, const T2 & rhs)
+		{
+			typedef typename DivisionType<T1, T2>::type type;
+			return std::pow((type)lhs, (type)rhs);
+		}
+
+		template <typename T1, typename T2>
+		auto operator()(T1 && lhs, T2 && rhs) const
+		{
+			return BinaryValue<RealPower, typename std::decay<T1>::type, typename std::decay<T2>::type>::Get(lhs, rhs);
+		}
+
+		operator std::string() const
+		{
+			return "^";
+		}
+	};
+
+	template <typename T>
+	static inline FunctionExpression<SquareRoot, T> sqrt(const Expression<T>& operand)
+	{
+		return{ operand() };
+	}
+
+	template <typename T>
+	static inline FunctionExpression<Logarithm, T> log(const Expression<T>& operand)
+	{
+		return{ operand() };
+	}
+
+	template <typename Lhs, typename Rhs>
+	static inline typename std::enable_if<
+		ExpressionOperands<Lhs, Rhs>::value,
+		BinarryExpression<RealPower, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type>
+	>::type pow(const Lhs& base, const Rhs& exponent)
+	{
+		return{ ExpressionOperator<Lhs>::GetParam(base), ExpressionOperator<Rhs>::GetParam(exponent) };
+	}
+
+	template <size_t terms, class T>
+	struct Expander<terms, Expression<T>>
+	{
+		static inline auto Expand(const T & exp)
+		{
+			return Expander<terms, T>::Get(exp());
+		}
+	};
+	template <size_t terms, class T>
+	struct Expander<terms, FunctionExpression<Sinus, T>>
+	{
+		static inline auto Expand(const FunctionExpression<Sinus, T> & exp)
+		{
+			return TaylorSine<
+				terms,
+				typename TypeToFloat<
+					T
+				>::type
+			>::Get(
+				(typename TypeToFloat<T>::type)exp.m_operand
+			);
+		}
+	};
+	template <size_t terms, class T>
+	struct Expander<terms, FunctionExpression<Cosinus, T>>
+	{
+		static inline auto Expand(const FunctionExpression<Cosinus, T> & exp)
+		{
+			return TaylorCosine<
 				terms,
 				typename TypeToFloat<
 					T
 				>::type
 			>::Get(
-				(typename TypeToFloat<T>::type)exp.m_operand
+				(typename TypeToFloat<T>::type)exp.m_operand
+			);
+		}
+	};
+
+	template <size_t terms, class T>
+	static inline auto expand(const T & exp)
+	{
+		return Expander<terms, T>::Expand(exp);
+	}
+
+	template <class T, typename T1, typename T2>
+	static inline typename Binder<T, T1, typename ExpressionOperator<T2>::type>::type bind(const Expression<T> & expr, const T1& var, const T2& value)
+	{
+		return Binder<T, T1, typename ExpressionOperator<T2>::type>::Bind(expr(), var, ExpressionOperator<T2>::GetParam(value));
+	}
+
+	template <class T>
+	static inline auto derive(const Expression<T> & exp)
+	{
+		return Derivation<T>::Derive(exp());
+	}
+
+	template <class T>
+	struct Derivation<Expression<T>>
+	{
+		typedef typename Derivation<T>::type type;
+		static inline type Derive(const T& exp)
+		{
+			return Derivation<T>::Derive(exp);
+		}
+	};
+
+	template <class T1, class T2>
+	struct Derivation<BinarryExpression<Addition, T1, T2>>
+	{
+		typedef BinarryExpression<Addition, typename Derivation<T1>::type, typename Derivation<T2>::type> type;
+		static inline type Derive(const BinarryExpression<Addition, T1, T2> & exp)
+		{
+			return{ Derivation<T1>::Derive(exp.m_leftOperand), Derivation<T2>::Derive(exp.m_rightOperand) };
+		}
+	};
+
+	template <class T1, class T2>
+	struct Derivation<BinarryExpression<Subtraction, T1, T2>>
+	{
+		typedef BinarryExpression<Subtraction, typename Derivation<T1>::type, typename Derivation<T2>::type> type;
+		static inline type Derive(const BinarryExpression<Subtraction, T1, T2> & exp)
+		{
+			return{ Derivation<T1>::Derive(exp.m_leftOperand), Derivation<T2>::Derive(exp.m_rightOperand) };
+		}
+	};
+
+	template <class T1, class T2>
+	struct Derivation<BinarryExpression<Multiplication, T1, T2>>
+	{
+		typedef
+			BinarryExpression<
+				Addition,
+				BinarryExpression<
+					Multiplication,
+					typename Derivation<T1>::type,
+					T2
+				>,
+				BinarryExpression<
+					Multiplication,
+					T1,
+					typename Derivation<T2>::type
+				>
+			> type;
+		static inline type Derive(const BinarryExpression<Multiplication, T1, T2> & exp)
+		{
+			return
+			{
+				{ Derivation<T1>::Derive(exp.m_leftOperand), exp.m_rightOperand },
+				{ exp.m_leftOperand, Derivation<T2>::Derive(exp.m_rightOperand) }
+			};
+		}
+	};
+
+	template <class T1, class T2>
+	struct Derivation<BinarryExpression<Division, T1, T2>>
+	{
+		typedef
+			BinarryExpression<
+				Division,
+				BinarryExpression<
+					Subtraction,
+					BinarryExpression<
+						Multiplication,
+						typename Derivation<T1>::type,
+						T2
+					>,
+					BinarryExpression<
+						Multiplication,
+						T1,
+						typename Derivation<T2>::type
+					>
+				>,
+				PostfixExpression<Power<2>, T2>
+			> type;
+		static inline type Derive(const BinarryExpression<Division, T1, T2> & exp)
+		{
+			return
+			{
+				{
+					{ Derivation<T1>::Derive(exp.m_leftOperand), exp.m_rightOperand },
+					{ exp.m_leftOperand, Derivation<T2>::Derive(exp.m_rightOperand) }
+				},
+				power<2>(exp.m_rightOperand)
+			};
+		}
+	};
+
+	template <class Operator, class Operand>
+	struct Derivation<UnaryExpression<Operator, Operand> >
+	{
+		typedef
+			UnaryExpression<
+			Operator,
+			typename Derivation<Operand>::type
+			> type;
+		static inline type Derive(const UnaryExpression<Operator, Operand> & exp)
+		{
+			return{ Derivation<Operand>::Derive(exp.m_operand) };
+		}
+	};
+
+	template <typename T>
+	struct Derivation<Numeric<T>>
+	{
+		typedef Numeric<int> type;
+		static inline type Derive(const Numeric<T> &)
+		{
+			return{ 0 };
+		}
+	};
+
+	template <typename T, intmax_t N, intmax_t D>
+	struct Derivation<Constant<T, N, D>>
+	{
+		typedef Numeric<int> type;
+		static inline type Derive(const Constant<T, N, D> &)
+		{
+			return{ 0 };
+		}
+	};
+
+	template <typename T>
+	struct Derivation<FunctionExpression<Sinus, T>>
+	{
+		typedef BinarryExpression<Multiplication, FunctionExpression<Cosinus, T>, typename Derivation<T>::type> type;
+		static inline type Derive(const FunctionExpression<Sinus, T> & exp)
+		{
+			return
+			{
+				cos(exp.m_operand),
+				Derivation<T>::Derive(exp.m_operand)
+			};
+		}
+	};
+
+	template <typename T>
+	struct Derivation<FunctionExpression<Cosinus, T>>
+	{
+		typedef BinarryExpression<Multiplication, UnaryExpression<UnaryMinus, FunctionExpression<Sinus, T> >, typename Derivation<T>::type> type;
+		static inline type Derive(const FunctionExpression<Cosinus, T> & exp)
+		{
+			return
+			{
+				-sin(exp.m_operand),
+				Derivation<T>::Derive(exp.m_operand)
+			};
+		}
+	};
+
+	template <int p, typename T>
+	struct Derivation<PostfixExpression<Power<p>, T>>
+	{
+		typedef
+			BinarryExpression<
+				Multiplication,
+				BinarryExpression<
+					Multiplication,
+					Numeric<int>,
+					PostfixExpression<
+						Power<p - 1>,
+						T
+					>
+				>,
+				typename Derivation<T>::type
+			> type;
+		static inline type Derive(const PostfixExpression<Power<p>, T> & exp)
+		{
+			return
+			{
+				{ p, power<p - 1>(exp.m_operand) },
+				{ Derivation<T>::Derive(exp.m_operand) }
+			};
+		}
+	};
+
+	template <typename T>
+	struct Derivation<BinarryExpression<IntegerPower, T, Numeric<int> >>
+	{
+		typedef
+			BinarryExpression<
+				Multiplication,
+				BinarryExpression<
+					Multiplication,
+					Numeric<int>,
+					BinarryExpression<IntegerPower, T, Numeric<int> >
+				>,
+				typename Derivation<T>::type
+			> type;
+		static inline type Derive(const BinarryExpression<IntegerPower, T, Numeric<int> > & exp)
+		{
+			return
+			{
+				{ exp.m_rightOperand, power(exp.m_leftOperand, exp.m_rightOperand() - 1) },
+				{ Derivation<T>::Derive(exp.m_leftOperand) }
+			};
+		}
+	};
+
+	template <typename T>
+	struct Derivation<FunctionExpression<SquareRoot, T>>
+	{
+		typedef
+			BinarryExpression<
+				Division,
+				typename Derivation<T>::type,
+				BinarryExpression<Multiplication, Numeric<int>, FunctionExpression<SquareRoot, T> >
+			> type;
+		static inline type Derive(const FunctionExpression<SquareRoot, T> & exp)
+		{
+			return
+			{
+				Derivation<T>::Derive(exp.m_operand),
+				{ 2, exp }
+			};
+		}
+	};
+
+	template <typename T>
+	struct Derivation<FunctionExpression<Logarithm, T>>
+	{
+		typedef BinarryExpression<Division, typename Derivation<T>::type, T> type;
+		static inline type Derive(const FunctionExpression<Logarithm, T> & exp)
+		{
+			return{ Derivation<T>::Derive(exp.m_operand), exp.m_operand };
+		}
+	};
+
+	template <class T1, class T2, bool variable>
+	struct RealPowerDerivation;
+
+	template <class T1, class T2>
+	struct RealPowerDerivation<T1, T2, true>
+	{
+		typedef
+			BinarryExpression<
+				Multiplication,
+				BinarryExpression<RealPower, T1, T2>,
+				BinarryExpression<
+					Addition,
+					BinarryExpression<
+						Multiplication,
+						typename Derivation<T2>::type,
+						FunctionExpression<Logarithm, T1>
+					>,
+					BinarryExpression<
+						Multiplication,
+						T2,
+						BinarryExpression<Division, typename Derivation<T1>::type, T1>
+					>
+				>
+			> type;
+		static inline type Derive(const BinarryExpression<RealPower, T1, T2> & exp)
+		{
+			return
+			{
+				exp,
+				{
+					{ Derivation<T2>::Derive(exp.m_rightOperand), log(exp.m_leftOperand) },
+					{ exp.m_rightOperand, { Derivation<T1>::Derive(exp.m_leftOperand), exp.m_leftOperand } }
+				}
+			};
+		}
+	};
+
+	// A constant exponent has no log term, so negative bases stay defined.
+	template <class T1, class T2>
+	struct RealPowerDerivation<T1, T2, false>
+	{
+		typedef
+			BinarryExpression<
+				Multiplication,
+				BinarryExpression<
+					Multiplication,
+					T2,
+					BinarryExpression<RealPower, T1, BinarryExpression<Subtraction, T2, Numeric<int> > >
+				>,
+				typename Derivation<T1>::type
+			> type;
+		static inline type Derive(const BinarryExpression<RealPower, T1, T2> & exp)
+		{
+			return
+			{
+				{ exp.m_rightOperand, { exp.m_leftOperand, { exp.m_rightOperand, 1 } } },
+				Derivation<T1>::Derive(exp.m_leftOperand)
+			};
+		}
+	};
+
+	template <class T1, class T2>
+	struct Derivation<BinarryExpression<RealPower, T1, T2>> : RealPowerDerivation<T1, T2, HasVariables<T2>::value>
+	{
+	};
+
+	template <char id>
+	struct Derivation<Variable<id>>
+	{
+		typedef Numeric<int> type;
+		static inline type Derive(const Variable<id> &)
+		{
+			return{ 1 };
+		}
+	};
+
+	template <class T>
+	struct Lopital
+	{
+		typedef T type;
+		static inline type Get(const T & expr)
+		{
+			return expr;
+		}
+	};
+
+	template <class T>
+	struct Lopital<Expression<T>>
+	{
+		typedef typename Lopital<T>::type type;
+		static inline type Get(const Expression<T> & expr)
+		{
+			return Lopital<T>::Get(expr());
+		}
+	};
+
+	template <class T1, class T2>
+	struct Lopital<BinarryExpression<Division, T1, T2> >
+	{
+		typedef BinarryExpression<
+			Division,
+			typename Derivation<T1>::type,
+			typename Derivation<T2>::type
+		> type;
+		static inline type Get(const BinarryExpression<Division, T1, T2> & expr)
+		{
+			return{ derive(expr.m_leftOperand), derive(expr.m_rightOperand) };
+		}
+	};
+
+	template <class T>
+	static inline auto lopital(const T& expr)
+	{
+		return Lopital<T>::Get(expr);
+	}
+
+	template <typename T>
+	struct HasDivision;
+	template <char id>
+	struct HasDivision<Variable<id>>
+	{
+		static constexpr bool value = false;
+	};
+	template <typename T>
+	struct HasDivision<Numeric<T>>
+	{
+		static constexpr bool value = false;
+	};
+	template <typename T, intmax_t N, intmax_t D>
+	struct HasDivision<Constant<T, N, D>>
+	{
+		static constexpr bool value = false;
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct HasDivision<BinarryExpression<Operator, LeftOperand, RightOperand>>
+	{
+		static constexpr bool value = HasDivision<LeftOperand>::value || HasDivision<RightOperand>::value;
+	};
+	template <class LeftOperand, class RightOperand>
+	struct HasDivision<BinarryExpression<Division, LeftOperand, RightOperand>>
+	{
+		static constexpr bool value = true;
+	};
+	template <class Operator, class Operand>
+	struct HasDivision<UnaryExpression<Operator, Operand>>
+	{
+		static constexpr bool value = HasDivision<Operand>::value;
+	};
+	template <class F, class T>
+	struct HasDivision<FunctionExpression<F, T>>
+	{
+		static constexpr bool value = HasDivision<T>::value;
+	};
+	template <class Operator, class Operand>
+	struct HasDivision<PostfixExpression<Operator, Operand>>
+	{
+		static constexpr bool value = HasDivision<Operand>::value;
+	};
+	template <class T>
+	struct HasDivision<Expression<T>>
+	{
+		static constexpr bool value = HasDivision<T>::value;
+	};
+
+	template <class T1, class T2, bool first, bool second>
+	struct DivisionSegregator;
+	template <class T1, class T2>
+	struct DivisionSegregator<T1, T2, true, false>
+	{
+		typedef T1 type;
+		static inline type Get(const T1 & t1, const T2 &)
+		{
+			return t1;
+		}
+	};
+	template <class T1, class T2>
+	struct DivisionSegregator<T1, T2, false, true>
+	{
+		typedef T2 type;
+		static inline type Get(const T1 &, const T2 & t2)
+		{
+			return t2;
+		}
+	};
+	template <class T1, class T2>
+	struct DivisionSegregator<T1, T2, true, true>
+	{
+		typedef T1 type;
+		static inline type Get(const T1 & t1, const T2 &)
+		{
+			return t1;
+		}
+	};
+
+	template <typename T>
+	struct FirstDivision;
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct FirstDivision<BinarryExpression<Operator, LeftOperand, RightOperand>>
+	{
+		static constexpr bool value = false;
+		typedef typename FirstDivision<
+			typename DivisionSegregator<
+				LeftOperand,
+				RightOperand,
+				HasDivision<LeftOperand>::value,
+				HasDivision<RightOperand>::value
+			>::type
+		>::type type;
+		static inline type Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
+		{
+			return FirstDivision<
+				typename DivisionSegregator<
+					LeftOperand,
+					RightOperand,
+					HasDivision<LeftOperand>::value,
+					HasDivision<RightOperand>::value
+				>::type
+			>::Get(
+				DivisionSegregator<
+					LeftOperand,
+					RightOperand,
+					HasDivision<LeftOperand>::value,
+					HasDivision<RightOperand>::value
+				>::Get(expr.m_leftOperand, expr.m_rightOperand)
+				);
+		}
+	};
+	template <class LeftOperand, class RightOperand>
+	struct FirstDivision<BinarryExpression<Division, LeftOperand, RightOperand>>
+	{
+		static constexpr bool value = true;
+		typedef BinarryExpression<Division, LeftOperand, RightOperand> type;
+		static inline type Get(const BinarryExpression<Division, LeftOperand, RightOperand> & expr)
+		{
+			return{ expr.m_leftOperand, expr.m_rightOperand };
+		}
+	};
+	template <class F, class T>
+	struct FirstDivision<UnaryExpression<F, T>>
+	{
+		static constexpr bool value = false;
+		typedef typename FirstDivision<T>::type type;
+		static inline type Get(const UnaryExpression<F, T> & expr)
+		{
+			return FirstDivision<T>::Get(expr.m_operand);
+		}
+	};
+	template <class F, class T>
+	struct FirstDivision<FunctionExpression<F, T>>
+	{
+		static constexpr bool value = true;
+		typedef typename FirstDivision<T>::type type;
+		static inline type Get(const FunctionExpression<F, T> & expr)
+		{
+			return FirstDivision<T>::Get(expr.m_operand);
+		}
+	};
+	template <class F, class T>
+	struct FirstDivision<PostfixExpression<F, T>>
+	{
+		static constexpr bool value = true;
+		typedef typename FirstDivision<T>::type type;
+		static inline type Get(const PostfixExpression<F, T> & expr)
+		{
+			return FirstDivision<T>::Get(expr.m_operand);
+		}
+	};
+	template <class T>
+	struct FirstDivision<Expression<T>>
+	{
+		static constexpr bool value = FirstDivision<T>::value;
+		typedef typename FirstDivision<T>::type type;
+		static inline type Get(const Expression<T> & expr)
+		{
+			return FirstDivision<T>::Get(expr());
+		}
+	};
+
+	template <typename T1, typename T>
+	struct SimplifierBase;
+	template <class O, class L1, class R1, class L2, class R2>
+	struct SimplifierBase<BinarryExpression<O, L1, R1>, BinarryExpression<Division, L2, R2>>
+	{
+		typedef BinarryExpression<
+			Division,
+			BinarryExpression<
+				O,
+				BinarryExpression<
+					Multiplication,
+					L1,
+					R2
+				>,
+				BinarryExpression<
+					Multiplication,
+					R1,
+					R2
+				>
+			>,
+			R2
+		> type;
+
+		static inline type Simplify(const BinarryExpression<O, L1, R1> & lhs, const BinarryExpression<Division, L2, R2> & rhs)
+		{
+			return
+			{
+				{
+					lhs.m_leftOperand * rhs.m_rightOperand,
+					lhs.m_rightOperand * rhs.m_rightOperand
+				},
+				rhs.m_rightOperand
+			};
+		}
+	};
+	template <typename T1, typename T>
+	struct SimplifierBase<Expression<T1>, T>
+	{
+		typedef typename SimplifierBase<T1, T>::type type;
+		static inline type Simplify(const Expression<T1> & lhs, const T & rhs)
+		{
+			return SimplifierBase<T1, T>::Simplify(lhs(), rhs);
+		}
+	};
+
+	template <typename T1, typename T, bool first>
+	struct Simplifier
+	{
+		typedef typename SimplifierBase<T1, T>::type type;
+		static inline type Simplify(const T1 & lhs, const T & rhs)
+		{
+			return SimplifierBase<T1, T>::Simplify(lhs, rhs);
+		}
+	};
+	template <typename T1, typename T>
+	struct Simplifier<T1, T, true>
+	{
+		typedef T1 type;
+		static inline type Simplify(const T1 & expr, const T &)
+		{
+			return expr;
+		}
+	};
+	template <typename T1, typename T>
+	struct Simplifier<Expression<T1>, T, true>
+	{
+		typedef T1 type;
+		static inline type Simplify(const Expression<T1> & expr, const T &)
+		{
+			return expr();
+		}
+	};
+
+	template <class T>
+	static inline auto simplify(const T & expr)
+	{
+		return Simplifier<T, typename FirstDivision<T>::type, FirstDivision<T>::value>::Simplify(expr, FirstDivision<T>::Get(expr));
+	}
+
+	template <char id, typename toT, typename F>
+	struct LimitPoint
+	{
+		template <class T>
+		static inline F Get(const LimitParam<id, toT> & param, const T & expr)
+		{
+			Environment<typename Variables<T>::type, F> env;
+			env.Set(id, (F)ExpressionOperator<toT>::GetParam(param.m_to)());
+			return (F)evaluate(fuse(expr), env);
+		}
+	};
+
+	template <char id, class T>
+	struct RationalFunction
+	{
+		static constexpr bool value = false;
+	};
+	template <char id, class T1, class T2>
+	struct RationalFunction<id, BinarryExpression<Division, T1, T2> >
+	{
+		static constexpr bool value = PolynomialDegree<id, T1>::value >= 0 && PolynomialDegree<id, T2>::value >= 0;
+	};
+
+	struct RationalLimit
+	{
+		template <typename F, size_t n>
+		static inline std::array<F, n> Shift(std::array<F, n> coefficients, F point)
+		{
+			for (size_t i = 0; i + 1 < n; ++i)
+			{
+				for (size_t k = n - 1; k-- > i;) coefficients[k] += point * coefficients[k + 1];
+			}
+			return coefficients;
+		}
+
+		template <typename F, size_t n>
+		static inline size_t Order(const std::array<F, n> & coefficients, F point)
+		{
+			std::array<F, n> bounds;
+			for (size_t k = 0; k < n; ++k) bounds[k] = std::abs(coefficients[k]);
+			bounds = Shift(bounds, std::abs(point));
+			std::array<F, n> taylor = Shift(coefficients, point);
+			for (size_t k = 0; k < n; ++k)
+			{
+				if (std::abs(taylor[k]) > 4 * n * std::numeric_limits<F>::epsilon() * bounds[k]) return k;
+			}
+			return n;
+		}
+
+		template <typename F, size_t n, size_t m>
+		static inline F Point(const std::array<F, n> & numerator, const std::array<F, m> & denominator, F point)
+		{
+			size_t i = Order(numerator, point);
+			size_t j = Order(denominator, point);
+			if (j == m) return std::numeric_limits<F>::quiet_NaN();
+			if (i > j) return 0;
+			F ratio = Shift(numerator, point)[i] / Shift(denominator, point)[j];
+			if (i == j) return ratio;
+			// An odd pole has no two-sided limit once a 0/0 form cancels. A numerator that does not vanish
+			// keeps the signed infinity that direct evaluation gives, as for 1/x at 0.
+			if (i > 0 && (j - i) % 2 == 1) return std::numeric_limits<F>::quiet_NaN();
+			return ratio < 0 ? -std::numeric_limits<F>::infinity() : std::numeric_limits<F>::infinity();
+		}
+
+		template <typename F, size_t n>
+		static inline size_t Degree(const std::array<F, n> & coefficients)
+		{
+			F bound = 0;
+			for (size_t k = 0; k < n; ++k) bound = std::abs(coefficients[k]) > bound ? std::abs(coefficients[k]) : bound;
+			for (size_t k = n; k-- > 0;)
+			{
+				if (std::abs(coefficients[k]) > 4 * n * std::numeric_limits<F>::epsilon() * bound) return k;
+			}
+			return n;
+		}
+
+		template <typename F, size_t n, size_t m>
+		static inline F Infinity(const std::array<F, n> & numerator, const std::array<F, m> & denominator, F point)
+		{
+			size_t i = Degree(numerator);
+			size_t j = Degree(denominator);
+			if (j == m) return std::numeric_limits<F>::quiet_NaN();
+			if (i == n || i < j) return 0;
+			F ratio = numerator[i] / denominator[j];
+			if (i == j) return ratio;
+			if (point < 0 && (i - j) % 2 == 1) ratio = -ratio;
+			return ratio < 0 ? -std::numeric_limits<F>::infinity() : std::numeric_limits<F>::infinity();
+		}
+	};
+
+	template <char id, typename toT, class T, bool div, typename F = long double, bool rational = RationalFunction<id, T>::value>
+	struct Limit
+	{
+		static inline F Get(const LimitParam<id, toT> & param, const Expression<T> & expr)
+		{
+			return LimitPoint<id, toT, F>::Get(param, expr());
+		}
+	};
+	template <char id, typename toT, class T, typename F>
+	struct Limit<id, toT, T, true, F, false>
+	{
+		static inline F Get(const LimitParam<id, toT> & param, const Expression<T> & expr)
+		{
+			F result = 0;
+
+			auto derive1 = simplify(expr);
+			result = LimitPoint<id, toT, F>::Get(param, derive1);
+			if (!(result != result)) return result;
+
+			auto derive2 = lopital(derive1);
+			result = LimitPoint<id, toT, F>::Get(param, derive2);
+			if (!(result != result)) return result;
+
+			auto derive3 = lopital(derive2);
+			result = LimitPoint<id, toT, F>::Get(param, derive3);
+			if (!(result != result)) return result;
+
+			auto derive4 = lopital(derive3);
+			result = LimitPoint<id, toT, F>::Get(param, derive4);
+			if (!(result != result)) return result;
+
+			auto derive5 = lopital(derive4);
+			result = LimitPoint<id, toT, F>::Get(param, derive5);
+			if (!(result != result)) return result;
+
+			return result;
+		}
+	};
+
+	template <char id, typename toT, class T1, class T2, typename F>
+	struct Limit<id, toT, BinarryExpression<Division, T1, T2>, true, F, true>
+	{
+		static inline F Get(const LimitParam<id, toT> & param, const Expression<BinarryExpression<Division, T1, T2> > & expr)
+		{
+			auto numerator = PolynomialCoefficients<id, F, T1>::Get(expr().m_leftOperand);
+			auto denominator = PolynomialCoefficients<id, F, T2>::Get(expr().m_rightOperand);
+			F point = (F)ExpressionOperator<toT>::GetParam(param.m_to)();
+			if (std::isinf(point)) return RationalLimit::Infinity(numerator, denominator, point);
+			return RationalLimit::Point(numerator, denominator, point);
+		}
+	};
+
+	template<typename F = long double, char id, typename toT, class T>
+	static inline F lim(const LimitParam<id, toT> && param, const Expression<T> & expr)
+	{
+		return Limit<id, toT, T, HasDivision<T>::value, F>::Get(param, expr);
+	}
+
+	template <class T>
+	static inline UnaryExpression<UnaryMinus, T> operator-(const Expression<T>& value)
+	{
+		return UnaryExpression<UnaryMinus, T>(value());
+	}
+
+	template <class T>
+	static inline UnaryExpression<UnaryAddition, T> operator++(const Expression<T>& value)
+	{
+		return{ value() };
+	}
+
+	template <class T>
+	static inline UnaryExpression<UnarySubtraction, T> operator--(const Expression<T>& value)
+	{
+		return{ value() };
+	}
+
+	template <class Lhs, class Rhs>
+	static inline typename std::enable_if<
+		ExpressionOperands<Lhs, Rhs>::value,
+		BinarryExpression<Addition, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type>
+	>::type operator+(const Lhs& d1, const Rhs& d2)
+	{
+		return{ ExpressionOperator<Lhs>::GetParam(d1), ExpressionOperator<Rhs>::GetParam(d2) };
+	}
+
+	template <class Lhs, class Rhs>
+	static inline typename std::enable_if<
+		ExpressionOperands<Lhs, Rhs>::value,
+		BinarryExpression<Subtraction, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type>
+	>::type operator-(const Lhs& d1, const Rhs& d2)
+	{
+		return{ ExpressionOperator<Lhs>::GetParam(d1), ExpressionOperator<Rhs>::GetParam(d2) };
+	}
+
+	template <class Lhs, class Rhs>
+	static inline typename std::enable_if<
+		ExpressionOperands<Lhs, Rhs>::value,
+		BinarryExpression<Multiplication, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type>
+	>::type operator*(const Lhs& d1, const Rhs& d2)
+	{
+		return{ ExpressionOperator<Lhs>::GetParam(d1), ExpressionOperator<Rhs>::GetParam(d2) };
+	}
+
+	template <class Lhs, class Rhs>
+	static inline typename std::enable_if<
+		ExpressionOperands<Lhs, Rhs>::value,
+		BinarryExpression<Division, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type>
+	>::type operator/(const Lhs& d1, const Rhs& d2)
+	{
+		return{ ExpressionOperator<Lhs>::GetParam(d1), ExpressionOperator<Rhs>::GetParam(d2) };
+	}
+
+	static inline size_t HashCombine(size_t seed, size_t value)
+	{
+		return seed ^ (value + (size_t)0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+	}
+
+	class Arena
+	{
+	public:
+		explicit Arena(size_t blockSize = 64 * 1024)
+			: m_blockSize(blockSize),
+			m_first(nullptr),
+			m_current(nullptr),
+			m_position(nullptr),
+			m_end(nullptr)
+		{
+		}
+
+		Arena(const Arena &) = delete;
+		Arena & operator=(const Arena &) = delete;
+
+		~Arena()
+		{
+			while (m_first)
+			{
+				Block * next = m_first->m_next;
+				::operator delete(m_first);
+				m_first = next;
+			}
+		}
+
+		void * Allocate(size_t size, size_t alignment)
+		{
+			char * position = Align(m_position, alignment);
+			while (!m_current || position + size > m_end)
+			{
+				Next(size + alignment);
+				position = Align(m_position, alignment);
+			}
+			m_position = position + size;
+			return position;
+		}
+
+		template <class T, class... Args>
+		T * Create(Args &&... args)
+		{
+			static_assert(std::is_trivially_destructible<T>::value, "arena objects are released without destruction");
+			return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		void Release()
+		{
+			m_current = m_first;
+			m_position = m_first ? m_first->Begin() : nullptr;
+			m_end = m_first ? m_first->End() : nullptr;
+		}
+
+	private:
+		struct Block
+		{
+			Block * m_next;
+			size_t m_size;
+
+			char * Begin()
+			{
+				return reinterpret_cast<char *>(this + 1);
+			}
+
+			char * End()
+			{
+				return Begin() + m_size;
+			}
+		};
+
+		static inline char * Align(char * position, size_t alignment)
+		{
+			std::uintptr_t address = reinterpret_cast<std::uintptr_t>(position);
+			return reinterpret_cast<char *>((address + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+		}
+
+		void Next(size_t size)
+		{
+			Block * next = m_current ? m_current->m_next : m_first;
+			if (!next || next->m_size < size)
+			{
+				size_t capacity = size > m_blockSize ? size : m_blockSize;
+				Block * block = static_cast<Block *>(::operator new(sizeof(Block) + capacity));
+				block->m_size = capacity;
+				block->m_next = next;
+				if (m_current) m_current->m_next = block;
+				else m_first = block;
+				next = block;
+			}
+			m_current = next;
+			m_position = next->Begin();
+			m_end = next->End();
+		}
+
+		size_t m_blockSize;
+		Block * m_first;
+		Block * m_current;
+		char * m_position;
+		char * m_end;
+	};
+
+	enum class NodeKind : char
+	{
+		Value,
+		Constant,
+		Variable,
+		Minus,
+		Increment,
+		Decrement,
+		Addition,
+		Subtraction,
+		Multiplication,
+		Division,
+		Power,
+		Sinus,
+		Cosinus,
+		SquareRoot,
+		Logarithm,
+		RealPower
+	};
+
+	struct Node
+	{
+		NodeKind m_kind;
+		char m_id;
+		int m_power;
+		long double m_value;
+		const char * m_name;
+		const Node * m_leftOperand;
+		const Node * m_rightOperand;
+	};
+
+	template <class Operator>
+	struct NodeOperator;
+	template <>
+	struct NodeOperator<UnaryMinus>
+	{
+		static constexpr NodeKind kind = NodeKind::Minus;
+	};
+	template <>
+	struct NodeOperator<UnaryAddition>
+	{
+		static constexpr NodeKind kind = NodeKind::Increment;
+	};
+	template <>
+	struct NodeOperator<UnarySubtraction>
+	{
+		static constexpr NodeKind kind = NodeKind::Decrement;
+	};
+	template <>
+	struct NodeOperator<Addition>
+	{
+		static constexpr NodeKind kind = NodeKind::Addition;
+	};
+	template <>
+	struct NodeOperator<Subtraction>
+	{
+		static constexpr NodeKind kind = NodeKind::Subtraction;
+	};
+	template <>
+	struct NodeOperator<Multiplication>
+	{
+		static constexpr NodeKind kind = NodeKind::Multiplication;
+	};
+	template <>
+	struct NodeOperator<Division>
+	{
+		static constexpr NodeKind kind = NodeKind::Division;
+	};
+	template <>
+	struct NodeOperator<Sinus>
+	{
+		static constexpr NodeKind kind = NodeKind::Sinus;
+	};
+	template <>
+	struct NodeOperator<Cosinus>
+	{
+		static constexpr NodeKind kind = NodeKind::Cosinus;
+	};
+	template <>
+	struct NodeOperator<SquareRoot>
+	{
+		static constexpr NodeKind kind = NodeKind::SquareRoot;
+	};
+	template <>
+	struct NodeOperator<Logarithm>
+	{
+		static constexpr NodeKind kind = NodeKind::Logarithm;
+	};
+	template <>
+	struct NodeOperator<RealPower>
+	{
+		static constexpr NodeKind kind = NodeKind::RealPower;
+	};
+
+	struct NodeFactory
+	{
+		static inline const Node * Value(Arena & arena, long double value)
+		{
+			return arena.Create<Node>(Node{ NodeKind::Value, 0, 0, value, nullptr, nullptr, nullptr });
+		}
+		static inline const Node * Constant(Arena & arena, long double value, const char * name)
+		{
+			return arena.Create<Node>(Node{ NodeKind::Constant, 0, 0, value, name, nullptr, nullptr });
+		}
+		static inline const Node * Variable(Arena & arena, char id)
+		{
+			return arena.Create<Node>(Node{ NodeKind::Variable, id, 0, 0, nullptr, nullptr, nullptr });
+		}
+		static inline const Node * Unary(Arena & arena, NodeKind kind, const Node * operand)
+		{
+			return arena.Create<Node>(Node{ kind, 0, 0, 0, nullptr, operand, nullptr });
+		}
+		static inline const Node * Binary(Arena & arena, NodeKind kind, const Node * lhs, const Node * rhs)
+		{
+			return arena.Create<Node>(Node{ kind, 0, 0, 0, nullptr, lhs, rhs });
+		}
+		static inline const Node * Power(Arena & arena, int p, const Node * operand)
+		{
+			return arena.Create<Node>(Node{ NodeKind::Power, 0, p, 0, nullptr, operand, nullptr });
+		}
+	};
+
+	// Maps structurally equal nodes onto one instance, bottom-up.
+	struct NodeInterner
+	{
+		const Node * Intern(const Node * node, Arena & arena)
+		{
+			if (!node) return nullptr;
+			auto visited = m_visited.find(node);
+			if (visited != m_visited.end()) return visited->second;
+			Node key = *node;
+			key.m_leftOperand = Intern(node->m_leftOperand, arena);
+			key.m_rightOperand = Intern(node->m_rightOperand, arena);
+			size_t hash = HashCombine(HashCombine((size_t)key.m_kind, (size_t)(unsigned char)key.m_id), (size_t)key.m_power);
+			hash = HashCombine(HashCombine(hash, std::hash<long double>()(key.m_value)), std::hash<const void *>()(key.m_name));
+			hash = HashCombine(HashCombine(hash, std::hash<const void *>()(key.m_leftOperand)), std::hash<const void *>()(key.m_rightOperand));
+			const Node * result = nullptr;
+			auto range = m_nodes.equal_range(hash);
+			for (auto i = range.first; i != range.second && !result; ++i)
+			{
+				if (Same(*i->second, key)) result = i->second;
+			}
+			if (!result)
+			{
+				result = key.m_leftOperand == node->m_leftOperand && key.m_rightOperand == node->m_rightOperand ? node : arena.Create<Node>(key);
+				m_nodes.emplace(hash, result);
+			}
+			m_visited.emplace(node, result);
+			return result;
+		}
+
+	private:
+		static bool Same(const Node & lhs, const Node & rhs)
+		{
+			return lhs.m_kind == rhs.m_kind &&
+				lhs.m_id == rhs.m_id &&
+				lhs.m_power == rhs.m_power &&
+				lhs.m_value == rhs.m_value &&
+				std::signbit(lhs.m_value) == std::signbit(rhs.m_value) &&
+				lhs.m_name == rhs.m_name &&
+				lhs.m_leftOperand == rhs.m_leftOperand &&
+				lhs.m_rightOperand == rhs.m_rightOperand;
+		}
+
+		std::unordered_map<const Node *, const Node *> m_visited;
+		std::unordered_multimap<size_t, const Node *> m_nodes;
+	};
+
+	template <class T>
+	struct NodeBuilder;
+	template <class T>
+	struct NodeBuilder<Expression<T> > : NodeBuilder<T>
+	{
+	};
+	template <typename T>
+	struct NodeBuilder<Numeric<T> >
+	{
+		static inline const Node * Build(const Numeric<T> & expr, Arena & arena)
+		{
+			return NodeFactory::Value(arena, (long double)expr.m_value);
+		}
+	};
+	template <typename T, intmax_t N, intmax_t D>
+	struct NodeBuilder<Constant<T, N, D> >
+	{
+		static inline const Node * Build(const Constant<T, N, D> & expr, Arena & arena)
+		{
+			return NodeFactory::Constant(arena, (long double)expr(), TypeTraits<Constant<T, N, D> >::name);
+		}
+	};
+	template <char id>
+	struct NodeBuilder<Variable<id> >
+	{
+		static inline const Node * Build(const Variable<id> &, Arena & arena)
+		{
+			return NodeFactory::Variable(arena, id);
+		}
+	};
+	template <class Operator, class Operand>
+	struct NodeBuilder<UnaryExpression<Operator, Operand> >
+	{
+		static inline const Node * Build(const UnaryExpression<Operator, Operand> & expr, Arena & arena)
+		{
+			return NodeFactory::Unary(arena, NodeOperator<Operator>::kind, NodeBuilder<Operand>::Build(expr.m_operand, arena));
+		}
+	};
+	template <int p, class Operand>
+	struct NodeBuilder<PostfixExpression<Power<p>, Operand> >
+	{
+		static inline const Node * Build(const PostfixExpression<Power<p>, Operand> & expr, Arena & arena)
+		{
+			return NodeFactory::Power(arena, p, NodeBuilder<Operand>::Build(expr.m_operand, arena));
+		}
+	};
+	template <class Operand>
+	struct NodeBuilder<BinarryExpression<IntegerPower, Operand, Numeric<int> > >
+	{
+		static inline const Node * Build(const BinarryExpression<IntegerPower, Operand, Numeric<int> > & expr, Arena & arena)
+		{
+			return NodeFactory::Power(arena, expr.m_rightOperand(), NodeBuilder<Operand>::Build(expr.m_leftOperand, arena));
+		}
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct NodeBuilder<BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		static inline const Node * Build(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr, Arena & arena)
+		{
+			return NodeFactory::Binary(
+				arena,
+				NodeOperator<Operator>::kind,
+				NodeBuilder<LeftOperand>::Build(expr.m_leftOperand, arena),
+				NodeBuilder<RightOperand>::Build(expr.m_rightOperand, arena)
+			);
+		}
+	};
+	template <class F, class T>
+	struct NodeBuilder<FunctionExpression<F, T> >
+	{
+		static inline const Node * Build(const FunctionExpression<F, T> & expr, Arena & arena)
+		{
+			return NodeFactory::Unary(arena, NodeOperator<F>::kind, NodeBuilder<T>::Build(expr.m_operand, arena));
+		}
+	};
+
+	struct DynamicEnvironment
+	{
+		typedef long double value_type;
+
+		DynamicEnvironment()
+		{
+			for (auto & value : m_values) value = std::numeric_limits<long double>::quiet_NaN();
+		}
+
+		template <char id>
+		const long double & Get() const
+		{
+			return m_values[(unsigned char)id];
+		}
+
+		const long double & Get(char id) const
+		{
+			return m_values[(unsigned char)id];
+		}
+
+		template <char id>
+		DynamicEnvironment & Set(const Variable<id> &, long double value)
+		{
+			return Set(id, value);
+		}
+
+		DynamicEnvironment & Set(char id, long double value)
+		{
+			m_values[(unsigned char)id] = value;
+			return *this;
+		}
+
+		bool Find(char id, long double & value) const
+		{
+			if (m_values[(unsigned char)id] != m_values[(unsigned char)id]) return false;
+			value = m_values[(unsigned char)id];
+			return true;
+		}
+
+		long double m_values[256];
+	};
+
+	// sin and cos nodes over the same operand node share one sincos call per evaluation.
+	struct NodeEvaluator
+	{
+		typedef std::unordered_map<const Node *, std::pair<long double, long double> > SineCosineValues;
+
+		static long double Get(const Node * node, const DynamicEnvironment & env)
+		{
+			SineCosineValues shared;
+			return Get(node, env, shared);
+		}
+
+		static long double Get(const Node * node, const DynamicEnvironment & env, SineCosineValues & shared)
+		{
+			switch (node->m_kind)
+			{
+			case NodeKind::Value:
+			case NodeKind::Constant:
+				return node->m_value;
+			case NodeKind::Variable:
+				return env.Get(node->m_id);
+			case NodeKind::Minus:
+				return -Get(node->m_leftOperand, env, shared);
+			case NodeKind::Increment:
+				return Get(node->m_leftOperand, env, shared) + 1;
+			case NodeKind::Decrement:
+				return Get(node->m_leftOperand, env, shared) - 1;
+			case NodeKind::Addition:
+				return Get(node->m_leftOperand, env, shared) + Get(node->m_rightOperand, env, shared);
+			case NodeKind::Subtraction:
+				return Get(node->m_leftOperand, env, shared) - Get(node->m_rightOperand, env, shared);
+			case NodeKind::Multiplication:
+				return Get(node->m_leftOperand, env, shared) * Get(node->m_rightOperand, env, shared);
+			case NodeKind::Division:
+				return Get(node->m_leftOperand, env, shared) / Get(node->m_rightOperand, env, shared);
+			case NodeKind::Power:
+				return Power(Get(node->m_leftOperand, env, shared), node->m_power);
+			case NodeKind::Sinus:
+				return Shared(node->m_leftOperand, env, shared).first;
+			case NodeKind::Cosinus:
+				return Shared(node->m_leftOperand, env, shared).second;
+			case NodeKind::SquareRoot:
+				return std::sqrt(Get(node->m_leftOperand, env, shared));
+			case NodeKind::Logarithm:
+				return std::log(Get(node->m_leftOperand, env, shared));
+			case NodeKind::RealPower:
+				return std::pow(Get(node->m_leftOperand, env, shared), Get(node->m_rightOperand, env, shared));
+			}
+			return std::numeric_limits<long double>::quiet_NaN();
+		}
+
+		static const std::pair<long double, long double> & Shared(const Node * operand, const DynamicEnvironment & env, SineCosineValues & shared)
+		{
+			auto found = shared.find(operand);
+			if (found != shared.end()) return found->second;
+			auto values = sincos(Get(operand, env, shared));
+			return shared.emplace(operand, std::pair<long double, long double>(values.first, values.second)).first->second;
+		}
+
+		static long double Power(long double value, int p)
+		{
+			return IntegerPower::Get(value, p);
+		}
+	};
+
+	struct Output
+	{
+		static inline void Put(std::ostream & sink, char value)
+		{
+			sink.put(value);
+		}
+
+		static inline void Put(std::ostream & sink, const char * value)
+		{
+			sink << value;
+		}
+
+		static inline void Put(std::ostream & sink, const std::string & value)
+		{
+			sink.write(value.data(), (std::streamsize)value.size());
+		}
+
+		static inline void Put(std::string & sink, char value)
+		{
+			sink += value;
+		}
+
+		static inline void Put(std::string & sink, const char * value)
+		{
+			sink += value;
+		}
+
+		static inline void Put(std::string & sink, const std::string & value)
+		{
+			sink += value;
+		}
+
+		template <class Sink, typename T>
+		static inline void Number(Sink & sink, const T & value)
+		{
+			char buffer[64];
+			int length = Format(buffer, sizeof(buffer), value);
+			if (length >= 0 && (size_t)length < sizeof(buffer)) Put(sink, (const char *)buffer);
+			else Put(sink, std::to_string(value));
+		}
+
+	private:
+		template <typename T>
+		static inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type Format(char * buffer, size_t size, const T & value)
+		{
+			return std::snprintf(buffer, size, "%lld", (long long)value);
+		}
+
+		template <typename T>
+		static inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, int>::type Format(char * buffer, size_t size, const T & value)
+		{
+			return std::snprintf(buffer, size, "%llu", (unsigned long long)value);
+		}
+
+		static inline int Format(char * buffer, size_t size, float value)
+		{
+			return std::snprintf(buffer, size, "%f", (double)value);
+		}
+
+		static inline int Format(char * buffer, size_t size, double value)
+		{
+			return std::snprintf(buffer, size, "%f", value);
+		}
+
+		static inline int Format(char * buffer, size_t size, long double value)
+		{
+			return std::snprintf(buffer, size, "%Lf", value);
+		}
+	};
+
+	struct InfixFormat
+	{
+		template <class Sink, typename T>
+		static inline void Number(Sink & sink, const T & value)
+		{
+			Output::Number(sink, value);
+		}
+
+		template <class Sink>
+		static inline void Constant(Sink & sink, const char * name)
+		{
+			Output::Put(sink, name);
+		}
+
+		template <class Sink>
+		static inline void Variable(Sink & sink, char id)
+		{
+			Output::Put(sink, id);
+		}
+	};
+
+	struct PrefixFormat : InfixFormat
+	{
+	};
+
+	struct LatexFormat : InfixFormat
+	{
+		template <class Sink>
+		static inline void Constant(Sink & sink, const char * name)
+		{
+			if (std::string(name) == "pi") Output::Put(sink, "\\pi");
+			else Output::Put(sink, name);
+		}
+	};
+
+	template <class Operator>
+	struct OperatorName
+	{
+		static inline const std::string & Get(const Operator &)
+		{
+			static const std::string name = (std::string)Operator();
+			return name;
+		}
+	};
+
+	template <class Format, class Operator>
+	struct Notation
+	{
+		template <class Sink, class F>
+		static inline void Unary(Sink & sink, const Operator & op, const F & operand)
+		{
+			Output::Put(sink, '(');
+			Output::Put(sink, OperatorName<Operator>::Get(op));
+			operand();
+			Output::Put(sink, ')');
+		}
+
+		template <class Sink, class F>
+		static inline void Postfix(Sink & sink, const Operator & op, const F & operand)
+		{
+			Output::Put(sink, "((");
+			operand();
+			Output::Put(sink, ')');
+			Output::Put(sink, OperatorName<Operator>::Get(op));
+			Output::Put(sink, ')');
+		}
+
+		template <class Sink, class L, class R>
+		static inline void Binary(Sink & sink, const Operator & op, const L & lhs, const R & rhs)
+		{
+			Output::Put(sink, '(');
+			lhs();
+			Output::Put(sink, OperatorName<Operator>::Get(op));
+			rhs();
+			Output::Put(sink, ')');
+		}
+
+		template <class Sink, class F>
+		static inline void Function(Sink & sink, const Operator & op, const F & operand)
+		{
+			Output::Put(sink, OperatorName<Operator>::Get(op));
+			Output::Put(sink, '(');
+			operand();
+			Output::Put(sink, ')');
+		}
+
+		template <class Sink, class F>
+		static inline void Variadic(Sink & sink, const Operator & op, size_t count, const F & operand)
+		{
+			Output::Put(sink, '(');
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (i) Output::Put(sink, OperatorName<Operator>::Get(op));
+				operand(i);
+			}
+			Output::Put(sink, ')');
+		}
+	};
+
+	template <class Operator>
+	struct Notation<PrefixFormat, Operator>
+	{
+		template <class Sink, class F>
+		static inline void Unary(Sink & sink, const Operator & op, const F & operand)
+		{
+			Variadic(sink, op, 1, [&](size_t) { operand(); });
+		}
+
+		template <class Sink, class F>
+		static inline void Postfix(Sink & sink, const Operator & op, const F & operand)
+		{
+			Variadic(sink, op, 1, [&](size_t) { operand(); });
+		}
+
+		template <class Sink, class L, class R>
+		static inline void Binary(Sink & sink, const Operator & op, const L & lhs, const R & rhs)
+		{
+			Variadic(sink, op, 2, [&](size_t i) { if (i) rhs(); else lhs(); });
+		}
+
+		template <class Sink, class F>
+		static inline void Function(Sink & sink, const Operator & op, const F & operand)
+		{
+			Variadic(sink, op, 1, [&](size_t) { operand(); });
+		}
+
+		template <class Sink, class F>
+		static inline void Variadic(Sink & sink, const Operator & op, size_t count, const F & operand)
+		{
+			Output::Put(sink, '(');
+			Output::Put(sink, OperatorName<Operator>::Get(op));
+			for (size_t i = 0; i < count; ++i)
+			{
+				Output::Put(sink, ' ');
+				operand(i);
+			}
+			Output::Put(sink, ')');
+		}
+	};
+
+	template <class Operator>
+	struct LatexName : OperatorName<Operator>
+	{
+	};
+	template <>
+	struct LatexName<Multiplication>
+	{
+		static inline const char * Get(const Multiplication &)
+		{
+			return " \\cdot ";
+		}
+	};
+	template <>
+	struct LatexName<Sinus>
+	{
+		static inline const char * Get(const Sinus &)
+		{
+			return "\\sin";
+		}
+	};
+	template <>
+	struct LatexName<Cosinus>
+	{
+		static inline const char * Get(const Cosinus &)
+		{
+			return "\\cos";
+		}
+	};
+	template <>
+	struct LatexName<Logarithm>
+	{
+		static inline const char * Get(const Logarithm &)
+		{
+			return "\\ln";
+		}
+	};
+
+	template <class Operator>
+	struct Notation<LatexFormat, Operator>
+	{
+		template <class Sink, class F>
+		static inline void Unary(Sink & sink, const Operator & op, const F & operand)
+		{
+			Output::Put(sink, "\\left(");
+			Output::Put(sink, LatexName<Operator>::Get(op));
+			operand();
+			Output::Put(sink, "\\right)");
+		}
+
+		template <class Sink, class L, class R>
+		static inline void Binary(Sink & sink, const Operator & op, const L & lhs, const R & rhs)
+		{
+			Output::Put(sink, "\\left(");
+			lhs();
+			Output::Put(sink, LatexName<Operator>::Get(op));
+			rhs();
+			Output::Put(sink, "\\right)");
+		}
+
+		template <class Sink, class F>
+		static inline void Function(Sink & sink, const Operator & op, const F & operand)
+		{
+			Output::Put(sink, LatexName<Operator>::Get(op));
+			Output::Put(sink, "\\left(");
+			operand();
+			Output::Put(sink, "\\right)");
+		}
+
+		template <class Sink, class F>
+		static inline void Variadic(Sink & sink, const Operator & op, size_t count, const F & operand)
+		{
+			Output::Put(sink, "\\left(");
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (i) Output::Put(sink, LatexName<Operator>::Get(op));
+				operand(i);
+			}
+			Output::Put(sink, "\\right)");
+		}
+	};
+	template <>
+	struct Notation<LatexFormat, UnaryAddition> : Notation<LatexFormat, Addition>
+	{
+		template <class Sink, class F>
+		static inline void Unary(Sink & sink, const UnaryAddition &, const F & operand)
+		{
+			Notation<LatexFormat, Addition>::Binary(sink, Addition(), operand, [&]() { Output::Put(sink, '1'); });
+		}
+	};
+	template <>
+	struct Notation<LatexFormat, UnarySubtraction> : Notation<LatexFormat, Subtraction>
+	{
+		template <class Sink, class F>
+		static inline void Unary(Sink & sink, const UnarySubtraction &, const F & operand)
+		{
+			Notation<LatexFormat, Subtraction>::Binary(sink, Subtraction(), operand, [&]() { Output::Put(sink, '1'); });
+		}
+	};
+	template <>
+	struct Notation<LatexFormat, Division>
+	{
+		template <class Sink, class L, class R>
+		static inline void Binary(Sink & sink, const Division &, const L & lhs, const R & rhs)
+		{
+			Output::Put(sink, "\\frac{");
+			lhs();
+			Output::Put(sink, "}{");
+			rhs();
+			Output::Put(sink, '}');
+		}
+	};
+	template <>
+	struct Notation<LatexFormat, SquareRoot>
+	{
+		template <class Sink, class F>
+		static inline void Function(Sink & sink, const SquareRoot &, const F & operand)
+		{
+			Output::Put(sink, "\\sqrt{");
+			operand();
+			Output::Put(sink, '}');
+		}
+	};
+
+	struct LatexPowerNotation
+	{
+		template <class Sink, class L, class R>
+		static inline void Binary(Sink & sink, const L & lhs, const R & rhs)
+		{
+			Output::Put(sink, '{');
+			lhs();
+			Output::Put(sink, "}^{");
+			rhs();
+			Output::Put(sink, '}');
+		}
+	};
+	template <int p>
+	struct Notation<LatexFormat, Power<p> >
+	{
+		template <class Sink, class F>
+		static inline void Postfix(Sink & sink, const Power<p> &, const F & operand)
+		{
+			LatexPowerNotation::Binary(sink, operand, [&]() { Output::Number(sink, p); });
+		}
+	};
+	template <>
+	struct Notation<LatexFormat, IntegerPower>
+	{
+		template <class Sink, class L, class R>
+		static inline void Binary(Sink & sink, const IntegerPower &, const L & lhs, const R & rhs)
+		{
+			LatexPowerNotation::Binary(sink, lhs, rhs);
+		}
+	};
+	template <>
+	struct Notation<LatexFormat, RealPower>
+	{
+		template <class Sink, class L, class R>
+		static inline void Binary(Sink & sink, const RealPower &, const L & lhs, const R & rhs)
+		{
+			LatexPowerNotation::Binary(sink, lhs, rhs);
+		}
+	};
+
+	template <class T>
+	struct Writer
+	{
+		template <class Format, class Sink>
+		static inline void Write(const T & expr, Sink & sink)
+		{
+			Output::Put(sink, (std::string)expr);
+		}
+	};
+	template <class T>
+	struct Writer<Expression<T> > : Writer<T>
+	{
+	};
+	template <typename T>
+	struct Writer<Numeric<T> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const Numeric<T> & expr, Sink & sink)
+		{
+			Format::Number(sink, expr.m_value);
+		}
+	};
+	template <typename T, intmax_t N, intmax_t D>
+	struct Writer<Constant<T, N, D> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const Constant<T, N, D> &, Sink & sink)
+		{
+			Format::Constant(sink, TypeTraits<Constant<T, N, D> >::name);
+		}
+	};
+	template <char id>
+	struct Writer<Variable<id> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const Variable<id> &, Sink & sink)
+		{
+			Format::Variable(sink, id);
+		}
+	};
+	template <class Operator, class Operand>
+	struct Writer<UnaryExpression<Operator, Operand> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const UnaryExpression<Operator, Operand> & expr, Sink & sink)
+		{
+			Notation<Format, Operator>::Unary(sink, expr.m_operation, [&]() { Writer<Operand>::template Write<Format>(expr.m_operand, sink); });
+		}
+	};
+	template <class Operator, class Operand>
+	struct Writer<PostfixExpression<Operator, Operand> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const PostfixExpression<Operator, Operand> & expr, Sink & sink)
+		{
+			Notation<Format, Operator>::Postfix(sink, expr.m_operation, [&]() { Writer<Operand>::template Write<Format>(expr.m_operand, sink); });
+		}
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct Writer<BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr, Sink & sink)
+		{
+			Notation<Format, Operator>::Binary(
+				sink,
+				expr.m_operation,
+				[&]() { Writer<LeftOperand>::template Write<Format>(expr.m_leftOperand, sink); },
+				[&]() { Writer<RightOperand>::template Write<Format>(expr.m_rightOperand, sink); }
+			);
+		}
+	};
+	template <class F, class T>
+	struct Writer<FunctionExpression<F, T> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const FunctionExpression<F, T> & expr, Sink & sink)
+		{
+			Notation<Format, F>::Function(sink, expr.m_function, [&]() { Writer<T>::template Write<Format>(expr.m_operand, sink); });
+		}
+	};
+	template <class T, typename V>
+	struct Writer<BindView<T, V> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const BindView<T, V> & expr, Sink & sink)
+		{
+			Writer<T>::template Write<Format>(expr.m_expr, sink);
+		}
+	};
+
+	template <class Format = InfixFormat, class T, class Sink>
+	static inline void write(const Expression<T> & expr, Sink & sink)
+	{
+		Writer<T>::template Write<Format>(expr(), sink);
+	}
+
+	template <class Format, class T>
+	static inline std::string print(const Expression<T> & expr)
+	{
+		std::string result;
+		write<Format>(expr, result);
+		return result;
+	}
+
+	struct NodePower
+	{
+		int m_power;
+	};
+	template <>
+	struct OperatorName<NodePower>
+	{
+		static inline std::string Get(const NodePower & op)
+		{
+			return "^" + std::to_string(op.m_power);
+		}
+	};
+	template <>
+	struct Notation<LatexFormat, NodePower>
+	{
+		template <class Sink, class F>
+		static inline void Postfix(Sink & sink, const NodePower & op, const F & operand)
+		{
+			LatexPowerNotation::Binary(sink, operand, [&]() { Output::Number(sink, op.m_power); });
+		}
+	};
+
+	struct NodePrinter
+	{
+		static void Write(const Node * node, std::ostream & stream)
+		{
+			Write<InfixFormat>(node, stream);
+		}
+
+		template <class Format, class Sink>
+		static void Write(const Node * node, Sink & sink)
+		{
+			auto operand = [&]() { Write<Format>(node->m_leftOperand, sink); };
+			auto right = [&]() { Write<Format>(node->m_rightOperand, sink); };
+			switch (node->m_kind)
+			{
+			case NodeKind::Value:
+				if (node->m_value == (long double)(std::intmax_t)node->m_value) Format::Number(sink, (std::intmax_t)node->m_value);
+				else Format::Number(sink, node->m_value);
+				return;
+			case NodeKind::Constant:
+				Format::Constant(sink, node->m_name);
+				return;
+			case NodeKind::Variable:
+				Format::Variable(sink, node->m_id);
+				return;
+			case NodeKind::Minus:
+				Notation<Format, UnaryMinus>::Unary(sink, UnaryMinus(), operand);
+				return;
+			case NodeKind::Increment:
+				Notation<Format, UnaryAddition>::Unary(sink, UnaryAddition(), operand);
+				return;
+			case NodeKind::Decrement:
+				Notation<Format, UnarySubtraction>::Unary(sink, UnarySubtraction(), operand);
+				return;
+			case NodeKind::Addition:
+				Notation<Format, Addition>::Binary(sink, Addition(), operand, right);
+				return;
+			case NodeKind::Subtraction:
+				Notation<Format, Subtraction>::Binary(sink, Subtraction(), operand, right);
+				return;
+			case NodeKind::Multiplication:
+				Notation<Format, Multiplication>::Binary(sink, Multiplication(), operand, right);
+				return;
+			case NodeKind::Division:
+				Notation<Format, Division>::Binary(sink, Division(), operand, right);
+				return;
+			case NodeKind::Power:
+				Notation<Format, NodePower>::Postfix(sink, NodePower{ node->m_power }, operand);
+				return;
+			case NodeKind::Sinus:
+				Notation<Format, Sinus>::Function(sink, Sinus(), operand);
+				return;
+			case NodeKind::Cosinus:
+				Notation<Format, Cosinus>::Function(sink, Cosinus(), operand);
+				return;
+			case NodeKind::SquareRoot:
+				Notation<Format, SquareRoot>::Function(sink, SquareRoot(), operand);
+				return;
+			case NodeKind::Logarithm:
+				Notation<Format, Logarithm>::Function(sink, Logarithm(), operand);
+				return;
+			case NodeKind::RealPower:
+				Notation<Format, RealPower>::Binary(sink, RealPower(), operand, right);
+				return;
+			}
+		}
+	};
+
+	struct NodeBinder
+	{
+		static const Node * Bind(const Node * node, char id, const Node * value, Arena & arena)
+		{
+			std::unordered_map<const Node *, const Node *> bound;
+			return NodeInterner().Intern(Bind(node, id, value, arena, bound), arena);
+		}
+
+		static const Node * Bind(const Node * node, char id, const Node * value, Arena & arena, std::unordered_map<const Node *, const Node *> & bound)
+		{
+			auto found = bound.find(node);
+			if (found != bound.end()) return found->second;
+			const Node * result = Rule(node, id, value, arena, bound);
+			bound.emplace(node, result);
+			return result;
+		}
+
+	private:
+		static const Node * Rule(const Node * node, char id, const Node * value, Arena & arena, std::unordered_map<const Node *, const Node *> & bound)
+		{
+			switch (node->m_kind)
+			{
+			case NodeKind::Value:
+			case NodeKind::Constant:
+				return node;
+			case NodeKind::Variable:
+				return node->m_id == id ? value : node;
+			case NodeKind::Addition:
+			case NodeKind::Subtraction:
+			case NodeKind::Multiplication:
+			case NodeKind::Division:
+			case NodeKind::RealPower:
+			{
+				const Node * lhs = Bind(node->m_leftOperand, id, value, arena, bound);
+				const Node * rhs = Bind(node->m_rightOperand, id, value, arena, bound);
+				if (lhs == node->m_leftOperand && rhs == node->m_rightOperand) return node;
+				return NodeFactory::Binary(arena, node->m_kind, lhs, rhs);
+			}
+			default:
+			{
+				const Node * operand = Bind(node->m_leftOperand, id, value, arena, bound);
+				if (operand == node->m_leftOperand) return node;
+				return arena.Create<Node>(Node{ node->m_kind, 0, node->m_power, 0, nullptr, operand, nullptr });
+			}
+			}
+		}
+	};
+
+	struct NodeDerivation
+	{
+		static const Node * Derive(const Node * node, Arena & arena)
+		{
+			std::unordered_map<const Node *, const Node *> derived;
+			return NodeInterner().Intern(Derive(node, arena, derived), arena);
+		}
+
+		static const Node * Derive(const Node * node, Arena & arena, std::unordered_map<const Node *, const Node *> & derived)
+		{
+			auto found = derived.find(node);
+			if (found != derived.end()) return found->second;
+			const Node * result = Rule(node, arena, derived);
+			derived.emplace(node, result);
+			return result;
+		}
+
+	private:
+		static const Node * Rule(const Node * node, Arena & arena, std::unordered_map<const Node *, const Node *> & derived)
+		{
+			switch (node->m_kind)
+			{
+			case NodeKind::Value:
+			case NodeKind::Constant:
+				return NodeFactory::Value(arena, 0);
+			case NodeKind::Variable:
+				return NodeFactory::Value(arena, 1);
+			case NodeKind::Minus:
+			case NodeKind::Increment:
+			case NodeKind::Decrement:
+				return NodeFactory::Unary(arena, node->m_kind, Derive(node->m_leftOperand, arena, derived));
+			case NodeKind::Addition:
+			case NodeKind::Subtraction:
+				return NodeFactory::Binary(arena, node->m_kind, Derive(node->m_leftOperand, arena, derived), Derive(node->m_rightOperand, arena, derived));
+			case NodeKind::Multiplication:
+				return NodeFactory::Binary(
+					arena,
+					NodeKind::Addition,
+					NodeFactory::Binary(arena, NodeKind::Multiplication, Derive(node->m_leftOperand, arena, derived), node->m_rightOperand),
+					NodeFactory::Binary(arena, NodeKind::Multiplication, node->m_leftOperand, Derive(node->m_rightOperand, arena, derived))
+				);
+			case NodeKind::Division:
+				return NodeFactory::Binary(
+					arena,
+					NodeKind::Division,
+					NodeFactory::Binary(
+						arena,
+						NodeKind::Subtraction,
+						NodeFactory::Binary(arena, NodeKind::Multiplication, Derive(node->m_leftOperand, arena, derived), node->m_rightOperand),
+						NodeFactory::Binary(arena, NodeKind::Multiplication, node->m_leftOperand, Derive(node->m_rightOperand, arena, derived))
+					),
+					NodeFactory::Power(arena, 2, node->m_rightOperand)
+				);
+			case NodeKind::Power:
+				return NodeFactory::Binary(
+					arena,
+					NodeKind::Multiplication,
+					NodeFactory::Binary(
+						arena,
+						NodeKind::Multiplication,
+						NodeFactory::Value(arena, node->m_power),
+						NodeFactory::Power(arena, node->m_power - 1, node->m_leftOperand)
+					),
+					Derive(node->m_leftOperand, arena, derived)
+				);
+			case NodeKind::Sinus:
+				return NodeFactory::Binary(
+					arena,
+					NodeKind::Multiplication,
+					NodeFactory::Unary(arena, NodeKind::Cosinus, node->m_leftOperand),
+					Derive(node->m_leftOperand, arena, derived)
+				);
+			case NodeKind::Cosinus:
+				return NodeFactory::Binary(
+					arena,
+					NodeKind::Multiplication,
+					NodeFactory::Unary(arena, NodeKind::Minus, NodeFactory::Unary(arena, NodeKind::Sinus, node->m_leftOperand)),
+					Derive(node->m_leftOperand, arena, derived)
+				);
+			case NodeKind::SquareRoot:
+				return NodeFactory::Binary(
+					arena,
+					NodeKind::Division,
+					Derive(node->m_leftOperand, arena, derived),
+					NodeFactory::Binary(arena, NodeKind::Multiplication, NodeFactory::Value(arena, 2), node)
+				);
+			case NodeKind::Logarithm:
+				return NodeFactory::Binary(arena, NodeKind::Division, Derive(node->m_leftOperand, arena, derived), node->m_leftOperand);
+			case NodeKind::RealPower:
+				if (node->m_rightOperand->m_kind == NodeKind::Value || node->m_rightOperand->m_kind == NodeKind::Constant)
+				{
+					return NodeFactory::Binary(
+						arena,
+						NodeKind::Multiplication,
+						NodeFactory::Binary(
+							arena,
+							NodeKind::Multiplication,
+							node->m_rightOperand,
+							NodeFactory::Binary(
+								arena,
+								NodeKind::RealPower,
+								node->m_leftOperand,
+								NodeFactory::Binary(arena, NodeKind::Subtraction, node->m_rightOperand, NodeFactory::Value(arena, 1))
+							)
+						),
+						Derive(node->m_leftOperand, arena, derived)
+					);
+				}
+				return NodeFactory::Binary(
+					arena,
+					NodeKind::Multiplication,
+					node,
+					NodeFactory::Binary(
+						arena,
+						NodeKind::Addition,
+						NodeFactory::Binary(
+							arena,
+							NodeKind::Multiplication,
+							Derive(node->m_rightOperand, arena, derived),
+							NodeFactory::Unary(arena, NodeKind::Logarithm, node->m_leftOperand)
+						),
+						NodeFactory::Binary(
+							arena,
+							NodeKind::Multiplication,
+							node->m_rightOperand,
+							NodeFactory::Binary(arena, NodeKind::Division, Derive(node->m_leftOperand, arena, derived), node->m_leftOperand)
+						)
+					)
+				);
+			}
+			return nullptr;
+		}
+	};
+
+	struct DynamicExpression : Expression<DynamicExpression>
+	{
+		DynamicExpression(const Node * node, Arena & arena)
+			: m_node(node),
+			m_arena(&arena)
+		{
+		}
+
+		long double operator()() const
+		{
+			return NodeEvaluator::Get(m_node, DynamicEnvironment());
+		}
+
+		long double operator()(const DynamicEnvironment & env) const
+		{
+			return NodeEvaluator::Get(m_node, env);
+		}
+
+		operator std::string() const
+		{
+			return print(*this);
+		}
+
+		const Node * m_node;
+		Arena * m_arena;
+	};
+
+	template <class T>
+	static inline DynamicExpression build(const Expression<T> & expr, Arena & arena)
+	{
+		return{ NodeInterner().Intern(NodeBuilder<T>::Build(expr(), arena), arena), arena };
+	}
+
+	template <>
+	struct Derivation<DynamicExpression>
+	{
+		typedef DynamicExpression type;
+		static inline type Derive(const DynamicExpression & exp)
+		{
+			return{ NodeDerivation::Derive(exp.m_node, *exp.m_arena), *exp.m_arena };
+		}
+	};
+
+	template <char id, typename T>
+	struct Binder<DynamicExpression, Variable<id>, T>
+	{
+		typedef DynamicExpression type;
+		static inline type Bind(const DynamicExpression & exp, const Variable<id> &, const T & value)
+		{
+			Arena & arena = *exp.m_arena;
+			return{ NodeBinder::Bind(exp.m_node, id, NodeBuilder<T>::Build(value, arena), arena), arena };
+		}
+	};
+
+	template <>
+	struct Evaluator<DynamicExpression>
+	{
+		static inline long double Get(const DynamicExpression & expr, const DynamicEnvironment & env)
+		{
+			return expr(env);
+		}
+	};
+
+	template <>
+	struct Writer<DynamicExpression>
+	{
+		template <class Format, class Sink>
+		static inline void Write(const DynamicExpression & expr, Sink & sink)
+		{
+			NodePrinter::Write<Format>(expr.m_node, sink);
+		}
+	};
+
+	template <>
+	struct NodeBuilder<DynamicExpression>
+	{
+		static inline const Node * Build(const DynamicExpression & expr, Arena &)
+		{
+			return expr.m_node;
+		}
+	};
+
+	// Each queue fills one 64-byte line so that neighbouring workers do not contend on it.
+	// WorkStealingPool places the queues in storage it aligns itself, because C++14 allocators
+	// only guarantee alignof(std::max_align_t).
+	struct alignas(64) WorkStealingQueue
+	{
+		WorkStealingQueue()
+			: m_range(0)
+		{
+		}
+
+		void Reset(std::uint32_t begin, std::uint32_t end)
+		{
+			m_range.store(Pack(begin, end));
+		}
+
+		bool Pop(std::uint32_t & chunk)
+		{
+			std::uint64_t range = m_range.load();
+			for (;;)
+			{
+				std::uint32_t begin = (std::uint32_t)(range >> 32);
+				std::uint32_t end = (std::uint32_t)range;
+				if (begin >= end) return false;
+				if (m_range.compare_exchange_weak(range, Pack(begin + 1, end)))
+				{
+					chunk = begin;
+					return true;
+				}
+			}
+		}
+
+		bool Steal(std::uint32_t & chunk)
+		{
+			std::uint64_t range = m_range.load();
+			for (;;)
+			{
+				std::uint32_t begin = (std::uint32_t)(range >> 32);
+				std::uint32_t end = (std::uint32_t)range;
+				if (begin >= end) return false;
+				if (m_range.compare_exchange_weak(range, Pack(begin, end - 1)))
+				{
+					chunk = end - 1;
+					return true;
+				}
+			}
+		}
+
+	private:
+		static inline std::uint64_t Pack(std::uint32_t begin, std::uint32_t end)
+		{
+			return ((std::uint64_t)begin << 32) | end;
+		}
+
+		std::atomic<std::uint64_t> m_range;
+	};
+
+	struct WorkStealingPool
+	{
+		template <class F>
+		static void Run(std::uint32_t chunks, unsigned threads, const F & body)
+		{
+			if (threads == 0) threads = std::thread::hardware_concurrency();
+			if (threads == 0) threads = 1;
+			if (threads > chunks) threads = chunks ? chunks : 1;
+
+			std::vector<char> storage((threads + 1) * sizeof(WorkStealingQueue));
+			void * base = storage.data();
+			size_t space = storage.size();
+			WorkStealingQueue * queues = static_cast<WorkStealingQueue *>(std::align(alignof(WorkStealingQueue), threads * sizeof(WorkStealingQueue), base, space));
+			for (unsigned i = 0; i < threads; ++i)
+			{
+				new (queues + i) WorkStealingQueue();
+				queues[i].Reset(
+					(std::uint32_t)((std::uint64_t)chunks * i / threads),
+					(std::uint32_t)((std::uint64_t)chunks * (i + 1) / threads)
+				);
+			}
+
+			auto worker = [&](unsigned self)
+			{
+				std::uint32_t chunk;
+				for (;;)
+				{
+					if (queues[self].Pop(chunk))
+					{
+						body(chunk);
+						continue;
+					}
+					bool stolen = false;
+					for (unsigned k = 1; k < threads && !stolen; ++k)
+					{
+						stolen = queues[(self + k) % threads].Steal(chunk);
+					}
+					if (!stolen) return;
+					body(chunk);
+				}
+			};
+
+			std::vector<std::thread> pool;
+			pool.reserve(threads - 1);
+			for (unsigned i = 1; i < threads; ++i) pool.emplace_back(worker, i);
+			worker(0);
+			for (auto & thread : pool) thread.join();
+		}
+	};
+
+	template <class T, char id, typename I, typename O>
+	static inline void parallel_evaluate(const Expression<T> & expr, const Variable<id> &, const I * inputs, O * outputs, size_t count, unsigned threads = 0)
+	{
+		static constexpr size_t line = 64 / sizeof(O) ? 64 / sizeof(O) : 1;
+		static constexpr size_t chunk = ((4096 + line - 1) / line) * line;
+
+		size_t misalignment = reinterpret_cast<std::uintptr_t>(outputs) % 64;
+		size_t offset = misalignment && misalignment % sizeof(O) == 0 ? ((64 - misalignment) / sizeof(O)) % chunk : 0;
+		if (offset > count) offset = count;
+		std::uint32_t chunks = (std::uint32_t)(count > offset ? (count - offset + chunk - 1) / chunk : 1);
+
+		const T & tree = expr();
+		WorkStealingPool::Run(chunks, threads, [&](std::uint32_t index)
+		{
+			Environment<typename Variables<T>::type, typename FloatType<O>::type> env;
+			size_t begin = index ? offset + index * chunk : 0;
+			size_t end = offset + (index + 1) * chunk < count ? offset + (index + 1) * chunk : count;
+			for (size_t i = begin; i < end; ++i)
+			{
+				env.Set(id, (typename FloatType<O>::type)inputs[i]);
+				outputs[i] = (O)Evaluator<T>::Get(tree, env);
+			}
+		});
+	}
+
+	template <class T, char id, class Sink>
+	struct AdaptiveSampler
+	{
+		AdaptiveSampler(const T & expr, long double tolerance, Sink & sink)
+			: m_expr(expr),
+			m_tolerance(tolerance),
+			m_sink(sink),
+			m_evaluations(0)
+		{
+		}
+
+		long double Evaluate(long double x)
+		{
+			++m_evaluations;
+			m_environment.Set(id, x);
+			return (long double)Evaluator<T>::Get(m_expr, m_environment);
+		}
+
+		void Run(long double a, long double b, size_t depth)
+		{
+			static constexpr int intervals = 8;
+			long double x0 = a;
+			long double f0 = Evaluate(x0);
+			m_sink(x0, f0);
+			for (int i = 1; i <= intervals; ++i)
+			{
+				long double x1 = i == intervals ? b : a + (b - a) * i / intervals;
+				long double f1 = Evaluate(x1);
+				Refine(x0, f0, x1, f1, depth);
+				x0 = x1;
+				f0 = f1;
+			}
+		}
+
+		void Refine(long double x0, long double f0, long double x1, long double f1, size_t depth)
+		{
+			long double xm = (x0 + x1) / 2;
+			long double fm = Evaluate(xm);
+			long double error = std::abs(fm - (f0 + f1) / 2);
+			// An interval with no finite sample is outside the domain; it is emitted once, not refined.
+			bool defined = std::isfinite(f0) || std::isfinite(fm) || std::isfinite(f1);
+			if (depth > 0 && defined && !(error <= m_tolerance))
+			{
+				Refine(x0, f0, xm, fm, depth - 1);
+				Refine(xm, fm, x1, f1, depth - 1);
+			}
+			else
+			{
+				m_sink(xm, fm);
+				m_sink(x1, f1);
+			}
+		}
+
+		const T & m_expr;
+		long double m_tolerance;
+		Sink & m_sink;
+		size_t m_evaluations;
+		Environment<typename Variables<T>::type, long double> m_environment;
+	};
+
+	template <class T, char id, class Sink>
+	static inline size_t sample(const Expression<T> & expr, const Variable<id> &, long double a, long double b, long double tolerance, Sink && sink, size_t depth = 16)
+	{
+		AdaptiveSampler<T, id, typename std::remove_reference<Sink>::type> sampler(expr(), tolerance, sink);
+		sampler.Run(a, b, depth);
+		return sampler.m_evaluations;
+	}
+
+	template <class L, class Axes, size_t k = 0>
+	struct VariableListMask;
+	template <class L, size_t k>
+	struct VariableListMask<L, VariableList<>, k>
+	{
+		static constexpr unsigned value = 0;
+	};
+	template <class L, char head, char... tail, size_t k>
+	struct VariableListMask<L, VariableList<head, tail...>, k>
+	{
+		static constexpr unsigned value = (VariableListContains<L, head>::value ? 1u << k : 0u) | VariableListMask<L, VariableList<tail...>, k + 1>::value;
+	};
+
+	template <size_t N>
+	struct GridContext
+	{
+		static constexpr size_t tile = 32;
+
+		size_t m_extents[N];
+		std::vector<long double> m_coordinates[N];
+		size_t m_tileBegin[N];
+		size_t m_tileEnd[N];
+
+		template <class F>
+		void ForEachInTile(const F & f) const
+		{
+			size_t index[N];
+			for (size_t k = 0; k < N; ++k)
+			{
+				if (m_tileBegin[k] >= m_tileEnd[k]) return;
+				index[k] = m_tileBegin[k];
+			}
+			for (size_t t = 0;; ++t)
+			{
+				f(index, t);
+				size_t k = N;
+				while (k > 0 && ++index[k - 1] == m_tileEnd[k - 1])
+				{
+					index[k - 1] = m_tileBegin[k - 1];
+					--k;
+				}
+				if (k == 0) return;
+			}
+		}
+
+		template <class F>
+		void ForEachTile(const F & f)
+		{
+			for (size_t k = 0; k < N; ++k)
+			{
+				if (m_extents[k] == 0) return;
+				m_tileBegin[k] = 0;
+				m_tileEnd[k] = TileEnd(k, 0);
+			}
+			for (;;)
+			{
+				f();
+				size_t k = N;
+				while (k > 0)
+				{
+					m_tileBegin[k - 1] = m_tileEnd[k - 1];
+					if (m_tileBegin[k - 1] < m_extents[k - 1])
+					{
+						m_tileEnd[k - 1] = TileEnd(k - 1, m_tileBegin[k - 1]);
+						break;
+					}
+					m_tileBegin[k - 1] = 0;
+					m_tileEnd[k - 1] = TileEnd(k - 1, 0);
+					--k;
+				}
+				if (k == 0) return;
+			}
+		}
+
+	private:
+		size_t TileEnd(size_t k, size_t begin) const
+		{
+			size_t size = k + 2 >= N ? tile : 1;
+			return begin + size < m_extents[k] ? begin + size : m_extents[k];
+		}
+	};
+
+	template <class Derived, size_t N, unsigned mask>
+	struct GridNodeBase
+	{
+		static constexpr unsigned full = (1u << N) - 1;
+
+		long double Fetch(const GridContext<N> & ctx, const size_t * index, size_t t) const
+		{
+			if (mask == full) return m_values[t];
+			size_t offset = 0;
+			for (size_t k = 0; k < N; ++k)
+			{
+				if (mask & (1u << k)) offset = offset * ctx.m_extents[k] + index[k];
+			}
+			return m_values[offset];
+		}
+
+		void Fill(const GridContext<N> & ctx)
+		{
+			if (mask == full) return;
+			size_t size = 1;
+			size_t index[N];
+			for (size_t k = 0; k < N; ++k)
+			{
+				index[k] = 0;
+				if (mask & (1u << k)) size *= ctx.m_extents[k];
+			}
+			m_values.resize(size);
+			for (size_t o = 0; o < size; ++o)
+			{
+				m_values[o] = Self().Compute(ctx, index, 0);
+				for (size_t k = N; k > 0; --k)
+				{
+					if (!(mask & (1u << (k - 1)))) continue;
+					if (++index[k - 1] < ctx.m_extents[k - 1]) break;
+					index[k - 1] = 0;
+				}
+			}
+		}
+
+		void FillTile(const GridContext<N> & ctx)
+		{
+			if (mask != full) return;
+			m_values.resize(GridContext<N>::tile * GridContext<N>::tile);
+			ctx.ForEachInTile([&](const size_t * index, size_t t)
+			{
+				m_values[t] = Self().Compute(ctx, index, t);
+			});
+		}
+
+		Derived & Self()
+		{
+			return static_cast<Derived &>(*this);
+		}
+
+		std::vector<long double> m_values;
+	};
+
+	template <class T, class Axes>
+	struct GridNode : GridNodeBase<GridNode<T, Axes>, Axes::size, 0>
+	{
+		GridNode(const T & expr)
+			: m_value((long double)expr())
+		{
+		}
+
+		void Prepare(const GridContext<Axes::size> & ctx)
+		{
+			this->Fill(ctx);
+		}
+
+		void Tile(const GridContext<Axes::size> &)
+		{
+		}
+
+		long double Compute(const GridContext<Axes::size> &, const size_t *, size_t) const
+		{
+			return m_value;
+		}
+
+		long double m_value;
+	};
+	template <char id, class Axes>
+	struct GridNode<Variable<id>, Axes> : GridNodeBase<GridNode<Variable<id>, Axes>, Axes::size, VariableListMask<VariableList<id>, Axes>::value>
+	{
+		GridNode(const Variable<id> &)
+		{
+		}
+
+		void Prepare(const GridContext<Axes::size> & ctx)
+		{
+			this->Fill(ctx);
+		}
+
+		void Tile(const GridContext<Axes::size> & ctx)
+		{
+			this->FillTile(ctx);
+		}
+
+		long double Compute(const GridContext<Axes::size> & ctx, const size_t * index, size_t) const
+		{
+			if (!VariableListContains<Axes, id>::value) return std::numeric_limits<long double>::quiet_NaN();
+			return ctx.m_coordinates[VariableListIndex<Axes, id>::value][index[VariableListIndex<Axes, id>::value]];
+		}
+	};
+	template <class Operator, class Operand, class Axes>
+	struct GridNode<UnaryExpression<Operator, Operand>, Axes> : GridNodeBase<GridNode<UnaryExpression<Operator, Operand>, Axes>, Axes::size, VariableListMask<typename Variables<Operand>::type, Axes>::value>
+	{
+		GridNode(const UnaryExpression<Operator, Operand> & expr)
+			: m_operand(expr.m_operand)
+		{
+		}
+
+		void Prepare(const GridContext<Axes::size> & ctx)
+		{
+			m_operand.Prepare(ctx);
+			this->Fill(ctx);
+		}
+
+		void Tile(const GridContext<Axes::size> & ctx)
+		{
+			m_operand.Tile(ctx);
+			this->FillTile(ctx);
+		}
+
+		long double Compute(const GridContext<Axes::size> & ctx, const size_t * index, size_t t) const
+		{
+			return (long double)m_operation(m_operand.Fetch(ctx, index, t));
+		}
+
+		Operator m_operation;
+		GridNode<Operand, Axes> m_operand;
+	};
+	template <class Operator, class Operand, class Axes>
+	struct GridNode<PostfixExpression<Operator, Operand>, Axes> : GridNodeBase<GridNode<PostfixExpression<Operator, Operand>, Axes>, Axes::size, VariableListMask<typename Variables<Operand>::type, Axes>::value>
+	{
+		GridNode(const PostfixExpression<Operator, Operand> & expr)
+			: m_operand(expr.m_operand)
+		{
+		}
+
+		void Prepare(const GridContext<Axes::size> & ctx)
+		{
+			m_operand.Prepare(ctx);
+			this->Fill(ctx);
+		}
+
+		void Tile(const GridContext<Axes::size> & ctx)
+		{
+			m_operand.Tile(ctx);
+			this->FillTile(ctx);
+		}
+
+		long double Compute(const GridContext<Axes::size> & ctx, const size_t * index, size_t t) const
+		{
+			return (long double)m_operation(m_operand.Fetch(ctx, index, t));
+		}
+
+		Operator m_operation;
+		GridNode<Operand, Axes> m_operand;
+	};
+	template <class Operator, class LeftOperand, class RightOperand, class Axes>
+	struct GridNode<BinarryExpression<Operator, LeftOperand, RightOperand>, Axes> : GridNodeBase<
+		GridNode<BinarryExpression<Operator, LeftOperand, RightOperand>, Axes>,
+		Axes::size,
+		VariableListMask<typename Variables<BinarryExpression<Operator, LeftOperand, RightOperand> >::type, Axes>::value
+	>
+	{
+		GridNode(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
+			: m_leftOperand(expr.m_leftOperand),
+			m_rightOperand(expr.m_rightOperand)
+		{
+		}
+
+		void Prepare(const GridContext<Axes::size> & ctx)
+		{
+			m_leftOperand.Prepare(ctx);
+			m_rightOperand.Prepare(ctx);
+			this->Fill(ctx);
+		}
+
+		void Tile(const GridContext<Axes::size> & ctx)
+		{
+			m_leftOperand.Tile(ctx);
+			m_rightOperand.Tile(ctx);
+			this->FillTile(ctx);
+		}
+
+		long double Compute(const GridContext<Axes::size> & ctx, const size_t * index, size_t t) const
+		{
+			return (long double)m_operation(m_leftOperand.Fetch(ctx, index, t), m_rightOperand.Fetch(ctx, index, t));
+		}
+
+		Operator m_operation;
+		GridNode<LeftOperand, Axes> m_leftOperand;
+		GridNode<RightOperand, Axes> m_rightOperand;
+	};
+	template <class F, class T, class Axes>
+	struct GridNode<FunctionExpression<F, T>, Axes> : GridNodeBase<GridNode<FunctionExpression<F, T>, Axes>, Axes::size, VariableListMask<typename Variables<T>::type, Axes>::value>
+	{
+		GridNode(const FunctionExpression<F, T> & expr)
+			: m_operand(expr.m_operand)
+		{
+		}
+
+		void Prepare(const GridContext<Axes::size> & ctx)
+		{
+			m_operand.Prepare(ctx);
+			this->Fill(ctx);
+		}
+
+		void Tile(const GridContext<Axes::size> & ctx)
+		{
+			m_operand.Tile(ctx);
+			this->FillTile(ctx);
+		}
+
+		long double Compute(const GridContext<Axes::size> & ctx, const size_t * index, size_t t) const
+		{
+			return (long double)m_function(m_operand.Fetch(ctx, index, t));
+		}
+
+		F m_function;
+		GridNode<T, Axes> m_operand;
+	};
+	template <class Axes>
+	struct GridNode<AnyExpression, Axes> : GridNodeBase<GridNode<AnyExpression, Axes>, Axes::size, VariableListMask<typename Variables<AnyExpression>::type, Axes>::value>
+	{
+		struct Point
+		{
+			bool Find(char id, long double & value) const
+			{
+				int k = VariableListFind<Axes>::Get(id);
+				if (k < 0) return false;
+				value = m_ctx->m_coordinates[k][m_index[k]];
+				return true;
+			}
+
+			const GridContext<Axes::size> * m_ctx;
+			const size_t * m_index;
+		};
+
+		GridNode(const AnyExpression & expr)
+			: m_expr(expr)
+		{
+		}
+
+		void Prepare(const GridContext<Axes::size> & ctx)
+		{
+			this->Fill(ctx);
+		}
+
+		void Tile(const GridContext<Axes::size> & ctx)
+		{
+			this->FillTile(ctx);
+		}
+
+		long double Compute(const GridContext<Axes::size> & ctx, const size_t * index, size_t) const
+		{
+			return m_expr(AnyEnvironment(Point{ &ctx, index }));
+		}
+
+		AnyExpression m_expr;
+	};
+
+	template <class T, typename O, char... ids, typename... C>
+	static inline void evaluate_grid(const Expression<T> & expr, O * outputs, const GridAxis<ids, C> &... axes)
+	{
+		typedef VariableList<ids...> Axes;
+		static constexpr size_t N = sizeof...(ids);
+		static_assert(N > 0 && N <= 8 * sizeof(unsigned), "unsupported number of grid axes");
+
+		GridContext<N> ctx;
+		size_t axis = 0;
+		size_t expand[] =
+		{
+			(ctx.m_coordinates[axis].assign(axes.m_coordinates, axes.m_coordinates + axes.m_count), ctx.m_extents[axis] = axes.m_count, ++axis)...
+		};
+		(void)expand;
+		size_t strides[N];
+		for (size_t k = N; k > 0; --k) strides[k - 1] = k == N ? 1 : strides[k] * ctx.m_extents[k];
+
+		GridNode<T, Axes> root(expr());
+		root.Prepare(ctx);
+		ctx.ForEachTile([&]()
+		{
+			root.Tile(ctx);
+			ctx.ForEachInTile([&](const size_t * index, size_t t)
+			{
+				size_t offset = 0;
+				for (size_t k = 0; k < N; ++k) offset += index[k] * strides[k];
+				outputs[offset] = (O)root.Fetch(ctx, index, t);
+			});
+		});
+	}
+
+	enum class Quadrature
+	{
+		GaussKronrod,
+		TanhSinh
+	};
+
+	template <class T, char id>
+	struct Integrator
+	{
+		struct Panel
+		{
+			long double m_a;
+			long double m_b;
+			long double m_value;
+			long double m_error;
+
+			bool operator<(const Panel & panel) const
+			{
+				return m_error < panel.m_error;
+			}
+		};
+
+		Integrator(const T & expr)
+			: m_expr(expr)
+		{
+		}
+
+		void Evaluate(const long double * x, long double * f, size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				m_environment.Set(id, x[i]);
+				f[i] = (long double)Evaluator<T>::Get(m_expr, m_environment);
+			}
+		}
+
+		Panel Kronrod(long double a, long double b)
+		{
+			static constexpr long double xgk[8] =
+			{
+				0.991455371120812639206854697526329L, 0.949107912342758524526189684047851L,
+				0.864864423359769072789712788640926L, 0.741531185599394439863864773280788L,
+				0.586087235467691130294144845693013L, 0.405845151377397166906606412076961L,
+				0.207784955007898467600689403773245L, 0.000000000000000000000000000000000L
+			};
+			static constexpr long double wgk[8] =
+			{
+				0.022935322010529224963732008058970L, 0.063092092629978553290700663189204L,
+				0.104790010322250183839876322541518L, 0.140653259715525918745189590510238L,
+				0.169004726639267902826583426598550L, 0.190350578064785409913256402421014L,
+				0.204432940075298892414161999234649L, 0.209482141084727828012999174891714L
+			};
+			static constexpr long double wg[4] =
+			{
+				0.129484966168869693270611432679082L, 0.279705391489276667901467771423780L,
+				0.381830050505118944950369775488975L, 0.417959183673469387755102040816327L
+			};
+
+			long double center = (a + b) / 2;
+			long double half = (b - a) / 2;
+			long double x[15];
+			long double f[15];
+			for (size_t i = 0; i < 7; ++i)
+			{
+				x[2 * i] = center - half * xgk[i];
+				x[2 * i + 1] = center + half * xgk[i];
+			}
+			x[14] = center;
+			Evaluate(x, f, 15);
+
+			long double kronrod = wgk[7] * f[14];
+			long double gauss = wg[3] * f[14];
+			for (size_t i = 0; i < 7; ++i)
+			{
+				long double sum = f[2 * i] + f[2 * i + 1];
+				kronrod += wgk[i] * sum;
+				if (i % 2 == 1) gauss += wg[i / 2] * sum;
+			}
+			return{ a, b, kronrod * half, std::abs((kronrod - gauss) * half) };
+		}
+
+		long double GaussKronrod(long double a, long double b, long double tolerance, size_t limit)
+		{
+			std::vector<Panel> panels;
+			panels.push_back(Kronrod(a, b));
+			long double error = panels.front().m_error;
+			while (!(error <= tolerance) && panels.size() < limit)
+			{
+				std::pop_heap(panels.begin(), panels.end());
+				Panel worst = panels.back();
+				panels.pop_back();
+				long double middle = (worst.m_a + worst.m_b) / 2;
+				panels.push_back(Kronrod(worst.m_a, middle));
+				std::push_heap(panels.begin(), panels.end());
+				panels.push_back(Kronrod(middle, worst.m_b));
+				std::push_heap(panels.begin(), panels.end());
+				error = 0;
+				for (auto & panel : panels) error += panel.m_error;
+			}
+			long double result = 0;
+			for (auto & panel : panels) result += panel.m_value;
+			return result;
+		}
+
+		long double TanhSinh(long double a, long double b, long double tolerance, size_t levels)
+		{
+			static constexpr long double halfPi = 1.57079632679489661923132169163975L;
+			static constexpr long double range = 3.2L;
+			long double center = (a + b) / 2;
+			long double half = (b - a) / 2;
+
+			long double h = 1;
+			long double sum = 0;
+			long double previous = std::numeric_limits<long double>::quiet_NaN();
+			std::vector<long double> x;
+			std::vector<long double> weights;
+			std::vector<long double> f;
+			for (size_t level = 0; level <= levels; ++level)
+			{
+				x.clear();
+				weights.clear();
+				size_t start = level == 0 ? 0 : 1;
+				size_t step = level == 0 ? 1 : 2;
+				for (size_t k = start; k * h <= range; k += step)
+				{
+					long double t = k * h;
+					long double u = halfPi * std::sinh(t);
+					long double weight = halfPi * std::cosh(t) / (std::cosh(u) * std::cosh(u));
+					long double complement = 2 / (1 + std::exp(2 * u));
+					if (k == 0)
+					{
+						x.push_back(center);
+						weights.push_back(weight);
+						continue;
+					}
+					// Abscissae that round onto an endpoint are the only samples skipped.
+					long double upper = b - half * complement;
+					long double lower = a + half * complement;
+					if (upper != b && upper != a)
+					{
+						x.push_back(upper);
+						weights.push_back(weight);
+					}
+					if (lower != a && lower != b)
+					{
+						x.push_back(lower);
+						weights.push_back(weight);
+					}
+				}
+				f.resize(x.size());
+				Evaluate(x.data(), f.data(), x.size());
+				for (size_t i = 0; i < x.size(); ++i) sum += weights[i] * f[i];
+				long double estimate = sum * h * half;
+				if (level > 0 && std::abs(estimate - previous) <= tolerance) return estimate;
+				previous = estimate;
+				h /= 2;
+			}
+			return previous;
+		}
+
+		const T & m_expr;
+		Environment<typename Variables<T>::type, long double> m_environment;
+	};
+
+	template <class T, char id>
+	static inline long double integrate(const Expression<T> & expr, const Variable<id> &, long double a, long double b, long double tolerance = 1e-10L, Quadrature method = Quadrature::GaussKronrod)
+	{
+		Integrator<T, id> integrator(expr());
+		if (method == Quadrature::TanhSinh) return integrator.TanhSinh(a, b, tolerance, 10);
+		return integrator.GaussKronrod(a, b, tolerance, 1000);
+	}
+
+	template <class T, char id>
+	struct RootFinder
+	{
+		typedef typename Derivation<T>::type derivative;
+
+		struct State
+		{
+			long double m_x;
+			long double m_previous;
+			long double m_fprevious;
+			long double m_lower;
+			long double m_upper;
+			long double m_flower;
+			long double m_origin;
+			long double m_forigin;
+			long double m_step;
+			bool m_bracketed;
+			bool m_searching;
+			bool m_active;
+		};
+
+		RootFinder(const T & expr)
+			: m_expr(expr),
+			m_derivative(Derivation<T>::Derive(expr))
+		{
+		}
+
+		size_t Solve(const long double * starts, long double * roots, size_t count, long double tolerance, size_t iterations)
+		{
+			std::vector<State> states(count);
+			std::vector<long double> f(count);
+			std::vector<long double> df(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				states[i] = { starts[i], starts[i], std::numeric_limits<long double>::quiet_NaN(), 0, 0, 0, 0, 0, 0, false, false, true };
+				roots[i] = std::numeric_limits<long double>::quiet_NaN();
+			}
+
+			size_t active = count;
+			for (size_t iteration = 0; iteration < iterations && active > 0; ++iteration)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (!states[i].m_active) continue;
+					m_environment.Set(id, states[i].m_x);
+					f[i] = (long double)Evaluator<T>::Get(m_expr, m_environment);
+					df[i] = (long double)Evaluator<derivative>::Get(m_derivative, m_environment);
+				}
+				for (size_t i = 0; i < count; ++i)
+				{
+					State & state = states[i];
+					if (!state.m_active) continue;
+					long double x = Step(state, f[i], df[i]);
+					if (x != x)
+					{
+						state.m_active = false;
+						--active;
+					}
+					else if (std::abs(x - state.m_x) <= tolerance * (1 + std::abs(state.m_x)) || f[i] == 0)
+					{
+						roots[i] = f[i] == 0 ? state.m_x : x;
+						state.m_active = false;
+						--active;
+					}
+					else
+					{
+						state.m_x = x;
+					}
+				}
+			}
+			return (size_t)std::count_if(roots, roots + count, [](long double root) { return root == root; });
+		}
+
+		static long double Step(State & state, long double f, long double df)
+		{
+			long double x = state.m_x;
+			if (f != f) return (state.m_previous + x) / 2 == x ? f : (state.m_previous + x) / 2;
+
+			// Without a bracket and a usable slope, probe alternately on both sides of the stalled point
+			// with doubling steps until the sign changes, then continue with the bracketed iteration.
+			if (state.m_searching)
+			{
+				if ((f < 0) == (state.m_forigin < 0))
+				{
+					state.m_step = state.m_step > 0 ? -state.m_step : -2 * state.m_step;
+					long double probe = state.m_origin + state.m_step;
+					return std::isfinite(probe) ? probe : std::numeric_limits<long double>::quiet_NaN();
+				}
+				state.m_searching = false;
+				state.m_bracketed = true;
+				state.m_lower = state.m_origin;
+				state.m_flower = state.m_forigin;
+				state.m_upper = x;
+				state.m_previous = x;
+				state.m_fprevious = f;
+				return (state.m_origin + x) / 2;
+			}
+
+			if (state.m_bracketed)
+			{
+				if ((f < 0) == (state.m_flower < 0))
+				{
+					state.m_lower = x;
+					state.m_flower = f;
+				}
+				else
+				{
+					state.m_upper = x;
+				}
+			}
+			else if (state.m_fprevious == state.m_fprevious && (f < 0) != (state.m_fprevious < 0))
+			{
+				state.m_bracketed = true;
+				state.m_lower = state.m_previous;
+				state.m_flower = state.m_fprevious;
+				state.m_upper = x;
+			}
+			else if (state.m_fprevious == state.m_fprevious && std::abs(f) > std::abs(state.m_fprevious))
+			{
+				return (state.m_previous + x) / 2;
+			}
+
+			state.m_previous = x;
+			state.m_fprevious = f;
+
+			long double newton = x - f / df;
+			if (state.m_bracketed)
+			{
+				long double low = state.m_lower < state.m_upper ? state.m_lower : state.m_upper;
+				long double high = state.m_lower < state.m_upper ? state.m_upper : state.m_lower;
+				if (!(newton > low && newton < high)) newton = (state.m_lower + state.m_upper) / 2;
+			}
+			else if (!std::isfinite(newton))
+			{
+				state.m_searching = true;
+				state.m_origin = x;
+				state.m_forigin = f;
+				state.m_step = (1 + std::abs(x)) / 64;
+				return x + state.m_step;
+			}
+			return newton;
+		}
+
+		const T & m_expr;
+		derivative m_derivative;
+		Environment<typename VariableListUnion<typename Variables<T>::type, typename Variables<derivative>::type>::type, long double> m_environment;
+	};
+
+	template <class T, char id>
+	static inline size_t find_roots(const Expression<T> & expr, const Variable<id> &, const long double * starts, long double * roots, size_t count, long double tolerance = 1e-12L, size_t iterations = 100)
+	{
+		RootFinder<T, id> finder(expr());
+		return finder.Solve(starts, roots, count, tolerance, iterations);
+	}
+
+	template <class T, char id>
+	static inline std::vector<long double> find_roots(const Expression<T> & expr, const Variable<id> & var, const std::vector<long double> & starts, long double tolerance = 1e-12L, size_t iterations = 100)
+	{
+		std::vector<long double> roots(starts.size());
+		find_roots(expr, var, starts.data(), roots.data(), starts.size(), tolerance, iterations);
+		return roots;
+	}
+
+	template <size_t n>
+	struct TaylorSeries
+	{
+		static_assert(n > 0, "a Taylor series needs at least one coefficient");
+
+		TaylorSeries()
+		{
+			for (auto & c : m_coefficients) c = 0;
+		}
+
+		TaylorSeries(long double value)
+			: TaylorSeries()
+		{
+			m_coefficients[0] = value;
+		}
+
+		long double & operator[](size_t k)
+		{
+			return m_coefficients[k];
+		}
+
+		const long double & operator[](size_t k) const
+		{
+			return m_coefficients[k];
+		}
+
+		TaylorSeries & operator++()
+		{
+			++m_coefficients[0];
+			return *this;
+		}
+
+		TaylorSeries & operator--()
+		{
+			--m_coefficients[0];
+			return *this;
+		}
+
+		friend TaylorSeries operator-(const TaylorSeries & value)
+		{
+			TaylorSeries result;
+			for (size_t k = 0; k < n; ++k) result[k] = -value[k];
+			return result;
+		}
+
+		friend TaylorSeries operator+(const TaylorSeries & lhs, const TaylorSeries & rhs)
+		{
+			TaylorSeries result;
+			for (size_t k = 0; k < n; ++k) result[k] = lhs[k] + rhs[k];
+			return result;
+		}
+
+		friend TaylorSeries operator-(const TaylorSeries & lhs, const TaylorSeries & rhs)
+		{
+			TaylorSeries result;
+			for (size_t k = 0; k < n; ++k) result[k] = lhs[k] - rhs[k];
+			return result;
+		}
+
+		friend TaylorSeries operator*(const TaylorSeries & lhs, const TaylorSeries & rhs)
+		{
+			TaylorSeries result;
+			for (size_t k = 0; k < n; ++k)
+			{
+				for (size_t j = 0; j <= k; ++j) result[k] += lhs[j] * rhs[k - j];
+			}
+			return result;
+		}
+
+		friend TaylorSeries operator/(const TaylorSeries & lhs, const TaylorSeries & rhs)
+		{
+			TaylorSeries result;
+			for (size_t k = 0; k < n; ++k)
+			{
+				long double c = lhs[k];
+				for (size_t j = 1; j <= k; ++j) c -= rhs[j] * result[k - j];
+				result[k] = c / rhs[0];
+			}
+			return result;
+		}
+
+		static void SinCos(const TaylorSeries & u, TaylorSeries & s, TaylorSeries & c)
+		{
+			s[0] = (long double)Sinus()((long double)u[0]);
+			c[0] = (long double)Cosinus()((long double)u[0]);
+			for (size_t k = 1; k < n; ++k)
+			{
+				long double ds = 0;
+				long double dc = 0;
+				for (size_t j = 1; j <= k; ++j)
+				{
+					ds += j * u[j] * c[k - j];
+					dc -= j * u[j] * s[k - j];
+				}
+				s[k] = ds / k;
+				c[k] = dc / k;
+			}
+		}
+
+		static TaylorSeries Sqrt(const TaylorSeries & u)
+		{
+			TaylorSeries result(std::sqrt(u[0]));
+			for (size_t k = 1; k < n; ++k)
+			{
+				long double c = u[k];
+				for (size_t j = 1; j < k; ++j) c -= result[j] * result[k - j];
+				result[k] = c / (2 * result[0]);
+			}
+			return result;
+		}
+
+		static TaylorSeries Log(const TaylorSeries & u)
+		{
+			TaylorSeries result(std::log(u[0]));
+			for (size_t k = 1; k < n; ++k)
+			{
+				long double c = 0;
+				for (size_t j = 1; j < k; ++j) c += j * result[j] * u[k - j];
+				result[k] = (u[k] - c / k) / u[0];
+			}
+			return result;
+		}
+
+		static TaylorSeries Exp(const TaylorSeries & u)
+		{
+			TaylorSeries result(std::exp(u[0]));
+			for (size_t k = 1; k < n; ++k)
+			{
+				long double c = 0;
+				for (size_t j = 1; j <= k; ++j) c += j * u[j] * result[k - j];
+				result[k] = c / k;
+			}
+			return result;
+		}
+
+		// u^a for a constant exponent, from u * p' = a * u' * p.
+		static TaylorSeries Pow(const TaylorSeries & u, long double a)
+		{
+			TaylorSeries result(std::pow(u[0], a));
+			for (size_t k = 1; k < n; ++k)
+			{
+				long double c = 0;
+				for (size_t j = 1; j <= k; ++j) c += ((a + 1) * j - (long double)k) * u[j] * result[k - j];
+				result[k] = c / (k * u[0]);
+			}
+			return result;
+		}
+
+		long double m_coefficients[n];
+	};
+
+	template <size_t n, class T, char id>
+	struct TaylorEvaluator
+	{
+		static inline TaylorSeries<n> Get(const T & expr, long double)
+		{
+			return{ (long double)expr() };
+		}
+	};
+	template <size_t n, class T, char id>
+	struct TaylorEvaluator<n, Expression<T>, id> : TaylorEvaluator<n, T, id>
+	{
+	};
+	template <size_t n, char var, char id>
+	struct TaylorEvaluator<n, Variable<var>, id>
+	{
+		static inline TaylorSeries<n> Get(const Variable<var> &, long double x0)
+		{
+			static_assert(var == id, "taylor_surrogate expands in a single variable; bind the others first");
+			TaylorSeries<n> result(x0);
+			if (n > 1) result[1] = 1;
+			return result;
+		}
+	};
+	template <size_t n, class Operator, class Operand, char id>
+	struct TaylorEvaluator<n, UnaryExpression<Operator, Operand>, id>
+	{
+		static inline TaylorSeries<n> Get(const UnaryExpression<Operator, Operand> & expr, long double x0)
+		{
+			return expr.m_operation(TaylorEvaluator<n, Operand, id>::Get(expr.m_operand, x0));
+		}
+	};
+	template <size_t n, class Operator, class Operand, char id>
+	struct TaylorEvaluator<n, PostfixExpression<Operator, Operand>, id>
+	{
+		static inline TaylorSeries<n> Get(const PostfixExpression<Operator, Operand> & expr, long double x0)
+		{
+			return expr.m_operation(TaylorEvaluator<n, Operand, id>::Get(expr.m_operand, x0));
+		}
+	};
+	template <size_t n, class Operator, class LeftOperand, class RightOperand, char id>
+	struct TaylorEvaluator<n, BinarryExpression<Operator, LeftOperand, RightOperand>, id>
+	{
+		static inline TaylorSeries<n> Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr, long double x0)
+		{
+			return expr.m_operation(
+				TaylorEvaluator<n, LeftOperand, id>::Get(expr.m_leftOperand, x0),
+				TaylorEvaluator<n, RightOperand, id>::Get(expr.m_rightOperand, x0)
+			);
+		}
+	};
+	template <size_t n, class T, char id>
+	struct TaylorEvaluator<n, FunctionExpression<Sinus, T>, id>
+	{
+		static inline TaylorSeries<n> Get(const FunctionExpression<Sinus, T> & expr, long double x0)
+		{
+			TaylorSeries<n> s, c;
+			TaylorSeries<n>::SinCos(TaylorEvaluator<n, T, id>::Get(expr.m_operand, x0), s, c);
+			return s;
+		}
+	};
+	template <size_t n, class T, char id>
+	struct TaylorEvaluator<n, FunctionExpression<Cosinus, T>, id>
+	{
+		static inline TaylorSeries<n> Get(const FunctionExpression<Cosinus, T> & expr, long double x0)
+		{
+			TaylorSeries<n> s, c;
+			TaylorSeries<n>::SinCos(TaylorEvaluator<n, T, id>::Get(expr.m_operand, x0), s, c);
+			return c;
+		}
+	};
+	template <size_t n, class T, char id>
+	struct TaylorEvaluator<n, FunctionExpression<SquareRoot, T>, id>
+	{
+		static inline TaylorSeries<n> Get(const FunctionExpression<SquareRoot, T> & expr, long double x0)
+		{
+			return TaylorSeries<n>::Sqrt(TaylorEvaluator<n, T, id>::Get(expr.m_operand, x0));
+		}
+	};
+	template <size_t n, class T, char id>
+	struct TaylorEvaluator<n, FunctionExpression<Logarithm, T>, id>
+	{
+		static inline TaylorSeries<n> Get(const FunctionExpression<Logarithm, T> & expr, long double x0)
+		{
+			return TaylorSeries<n>::Log(TaylorEvaluator<n, T, id>::Get(expr.m_operand, x0));
+		}
+	};
+	template <size_t n, class T, char id>
+	struct TaylorEvaluator<n, BinarryExpression<IntegerPower, T, Numeric<int> >, id>
+	{
+		static inline TaylorSeries<n> Get(const BinarryExpression<IntegerPower, T, Numeric<int> > & expr, long double x0)
+		{
+			return IntegerPower::Get(TaylorEvaluator<n, T, id>::Get(expr.m_leftOperand, x0), expr.m_rightOperand.m_value);
+		}
+	};
+	template <size_t n, class T1, class T2, char id>
+	struct TaylorEvaluator<n, BinarryExpression<RealPower, T1, T2>, id>
+	{
+		static inline TaylorSeries<n> Get(const BinarryExpression<RealPower, T1, T2> & expr, long double x0)
+		{
+			TaylorSeries<n> base = TaylorEvaluator<n, T1, id>::Get(expr.m_leftOperand, x0);
+			TaylorSeries<n> exponent = TaylorEvaluator<n, T2, id>::Get(expr.m_rightOperand, x0);
+			bool constant = true;
+			for (size_t k = 1; k < n; ++k) constant = constant && exponent[k] == 0;
+			if (constant) return TaylorSeries<n>::Pow(base, exponent[0]);
+			return TaylorSeries<n>::Exp(exponent * TaylorSeries<n>::Log(base));
+		}
+	};
+
+	template <size_t n>
+	struct TaylorPolynomial
+	{
+		long double operator()(long double x) const
+		{
+			long double h = x - m_center;
+			long double result = m_coefficients[n - 1];
+			for (size_t k = n - 1; k > 0; --k) result = result * h + m_coefficients[k - 1];
+			return result;
+		}
+
+		long double m_center;
+		long double m_coefficients[n];
+	};
+
+	template <size_t n, class T, char id>
+	static inline TaylorPolynomial<n> taylor_surrogate(const Expression<T> & expr, const Variable<id> &, long double x0)
+	{
+		TaylorSeries<n> series = TaylorEvaluator<n, T, id>::Get(expr(), x0);
+		TaylorPolynomial<n> result;
+		result.m_center = x0;
+		for (size_t k = 0; k < n; ++k) result.m_coefficients[k] = series[k];
+		return result;
+	}
+
+	struct ChebyshevSeries
+	{
+		long double operator()(long double x) const
+		{
+			long double t = (2 * x - m_a - m_b) / (m_b - m_a);
+			long double t2 = 2 * t;
+			long double b1 = 0;
+			long double b2 = 0;
+			for (size_t k = m_coefficients.size(); k > 1; --k)
+			{
+				long double b0 = m_coefficients[k - 1] + t2 * b1 - b2;
+				b2 = b1;
+				b1 = b0;
+			}
+			return m_coefficients[0] + t * b1 - b2;
+		}
+
+		template <typename I, typename O>
+		void operator()(const I * x, O * y, size_t count) const
+		{
+			const long double scale = 2 / (m_b - m_a);
+			const long double shift = (m_a + m_b) / (m_b - m_a);
+			const size_t degree = m_coefficients.size();
+			const long double * c = m_coefficients.data();
+			for (size_t i = 0; i < count; ++i)
+			{
+				long double t = x[i] * scale - shift;
+				long double t2 = 2 * t;
+				long double b1 = 0;
+				long double b2 = 0;
+				for (size_t k = degree; k > 1; --k)
+				{
+					long double b0 = c[k - 1] + t2 * b1 - b2;
+					b2 = b1;
+					b1 = b0;
+				}
+				y[i] = (O)(c[0] + t * b1 - b2);
+			}
+		}
+
+		long double m_a;
+		long double m_b;
+		long double m_error;
+		std::vector<long double> m_coefficients;
+	};
+
+	template <class T, char id>
+	struct ChebyshevFitter
+	{
+		ChebyshevFitter(const T & expr)
+			: m_expr(expr)
+		{
+		}
+
+		// The nodes and the transform share the angles pi * m / (2 * count), so one table of
+		// 4 * count cosines serves both and the transform needs no further cos calls.
+		void Coefficients(long double a, long double b, size_t count, std::vector<long double> & coefficients)
+		{
+			static constexpr long double pi = 3.14159265358979323846264338327950L;
+			const size_t period = 4 * count;
+			std::vector<long double> cosines(period);
+			for (size_t m = 0; m < period; ++m) cosines[m] = std::cos(pi * m / (2 * count));
+			std::vector<long double> values(count);
+			for (size_t j = 0; j < count; ++j)
+			{
+				m_environment.Set(id, (a + b) / 2 + (b - a) / 2 * cosines[2 * j + 1]);
+				values[j] = (long double)Evaluator<T>::Get(m_expr, m_environment);
+			}
+			coefficients.assign(count, 0);
+			for (size_t k = 0; k < count; ++k)
+			{
+				long double sum = 0;
+				size_t m = k;
+				for (size_t j = 0; j < count; ++j)
+				{
+					sum += values[j] * cosines[m];
+					m = (m + 2 * k) % period;
+				}
+				coefficients[k] = (k == 0 ? 1 : 2) * sum / count;
+			}
+		}
+
+		// Largest deviation between the expression and the series on a uniform grid twice as dense
+		// as the interpolation nodes, which catches aliasing the coefficient tail cannot show.
+		long double Deviation(const ChebyshevSeries & series, size_t count)
+		{
+			const size_t samples = 2 * count + 1;
+			long double deviation = 0;
+			for (size_t i = 0; i < samples; ++i)
+			{
+				long double x = series.m_a + (series.m_b - series.m_a) * i / (samples - 1);
+				m_environment.Set(id, x);
+				long double difference = std::abs((long double)Evaluator<T>::Get(m_expr, m_environment) - series(x));
+				if (!(difference <= deviation)) deviation = difference;
+			}
+			return deviation;
+		}
+
+		// The tolerance is relative to the largest coefficient. m_error is the larger of the dropped
+		// coefficient tail and the deviation measured by Deviation, so it is an estimate checked on
+		// a finite grid rather than a rigorous bound.
+		ChebyshevSeries Fit(long double a, long double b, long double tolerance, size_t limit)
+		{
+			ChebyshevSeries result;
+			result.m_a = a;
+			result.m_b = b;
+			std::vector<long double> coefficients;
+			for (size_t count = 16;; count *= 2)
+			{
+				Coefficients(a, b, count, coefficients);
+				long double scale = 0;
+				for (auto c : coefficients) scale = std::abs(c) > scale ? std::abs(c) : scale;
+				long double cutoff = tolerance * scale;
+				bool converged = true;
+				for (size_t k = count - 3; k < count; ++k) converged = converged && std::abs(coefficients[k]) <= cutoff;
+				if (converged || count * 2 > limit)
+				{
+					size_t degree = count;
+					long double error = 0;
+					while (degree > 1 && std::abs(coefficients[degree - 1]) + error <= cutoff)
+					{
+						error += std::abs(coefficients[degree - 1]);
+						--degree;
+					}
+					error += std::abs(coefficients[count - 1]);
+					coefficients.resize(degree);
+					result.m_coefficients = std::move(coefficients);
+					long double deviation = Deviation(result, count);
+					result.m_error = converged ? (deviation > error ? deviation : error) : std::numeric_limits<long double>::infinity();
+					return result;
+				}
+			}
+		}
+
+		const T & m_expr;
+		Environment<typename Variables<T>::type, long double> m_environment;
+	};
+
+	template <class T, char id>
+	static inline ChebyshevSeries chebyshev_fit(const Expression<T> & expr, const Variable<id> &, long double a, long double b, long double tolerance = 1e-12L, size_t limit = 4096)
+	{
+		ChebyshevFitter<T, id> fitter(expr());
+		return fitter.Fit(a, b, tolerance, limit);
+	}
+
+	enum class HashTag : size_t
+	{
+		Numeric = 1,
+		Constant,
+		Variable,
+		Unary,
+		Postfix,
+		Binary,
+		Function,
+		Node,
+		Variadic,
+		Polynomial,
+		Bound
+	};
+
+	template <class Operator>
+	struct OperatorHash
+	{
+		static inline size_t Get()
+		{
+			static const size_t value = std::hash<std::string>()((std::string)Operator());
+			return value;
+		}
+	};
+
+	template <class T>
+	struct Hasher<Expression<T> > : Hasher<T>
+	{
+	};
+	template <typename T>
+	struct Hasher<Numeric<T> >
+	{
+		static inline size_t Get(const Numeric<T> & expr)
+		{
+			return HashCombine((size_t)HashTag::Numeric, std::hash<T>()(expr.m_value));
+		}
+	};
+	template <typename T, intmax_t N, intmax_t D>
+	struct Hasher<Constant<T, N, D> >
+	{
+		static inline size_t Get(const Constant<T, N, D> &)
+		{
+			return HashCombine(HashCombine((size_t)HashTag::Constant, (size_t)N), (size_t)D);
+		}
+	};
+	template <char id>
+	struct Hasher<Variable<id> >
+	{
+		static inline size_t Get(const Variable<id> &)
+		{
+			return HashCombine((size_t)HashTag::Variable, (size_t)(unsigned char)id);
+		}
+	};
+	template <class Operator, class Operand>
+	struct Hasher<UnaryExpression<Operator, Operand> >
+	{
+		static inline size_t Get(const UnaryExpression<Operator, Operand> & expr)
+		{
+			return HashCombine(HashCombine((size_t)HashTag::Unary, OperatorHash<Operator>::Get()), Hasher<Operand>::Get(expr.m_operand));
+		}
+	};
+	template <class Operator, class Operand>
+	struct Hasher<PostfixExpression<Operator, Operand> >
+	{
+		static inline size_t Get(const PostfixExpression<Operator, Operand> & expr)
+		{
+			return HashCombine(HashCombine((size_t)HashTag::Postfix, OperatorHash<Operator>::Get()), Hasher<Operand>::Get(expr.m_operand));
+		}
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct Hasher<BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		static inline size_t Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
+		{
+			size_t seed = HashCombine((size_t)HashTag::Binary, OperatorHash<Operator>::Get());
+			seed = HashCombine(seed, Hasher<LeftOperand>::Get(expr.m_leftOperand));
+			return HashCombine(seed, Hasher<RightOperand>::Get(expr.m_rightOperand));
+		}
+	};
+	template <class F, class T>
+	struct Hasher<FunctionExpression<F, T> >
+	{
+		static inline size_t Get(const FunctionExpression<F, T> & expr)
+		{
+			return HashCombine(HashCombine((size_t)HashTag::Function, OperatorHash<F>::Get()), Hasher<T>::Get(expr.m_operand));
+		}
+	};
+
+	struct NodeHasher
+	{
+		static size_t Get(const Node * node)
+		{
+			std::unordered_map<const Node *, size_t> hashes;
+			return Get(node, hashes);
+		}
+
+		static size_t Get(const Node * node, std::unordered_map<const Node *, size_t> & hashes)
+		{
+			if (!node) return 0;
+			auto found = hashes.find(node);
+			if (found != hashes.end()) return found->second;
+			size_t seed = HashCombine((size_t)HashTag::Node, (size_t)node->m_kind);
+			seed = HashCombine(seed, (size_t)(unsigned char)node->m_id);
+			seed = HashCombine(seed, (size_t)node->m_power);
+			seed = HashCombine(seed, std::hash<long double>()(node->m_value));
+			seed = HashCombine(seed, Get(node->m_leftOperand, hashes));
+			seed = HashCombine(seed, Get(node->m_rightOperand, hashes));
+			hashes.emplace(node, seed);
+			return seed;
+		}
+
+		static bool Equal(const Node * lhs, const Node * rhs)
+		{
+			std::unordered_multimap<const Node *, const Node *> equal;
+			return Equal(lhs, rhs, equal);
+		}
+
+		// Remembers pairs already proven equal. A mismatch ends the whole walk,
+		// so each pair of shared nodes is compared at most once.
+		static bool Equal(const Node * lhs, const Node * rhs, std::unordered_multimap<const Node *, const Node *> & equal)
+		{
+			if (lhs == rhs) return true;
+			if (!lhs || !rhs) return false;
+			auto range = equal.equal_range(lhs);
+			for (auto i = range.first; i != range.second; ++i)
+			{
+				if (i->second == rhs) return true;
+			}
+			bool same = lhs->m_kind == rhs->m_kind &&
+				lhs->m_id == rhs->m_id &&
+				lhs->m_power == rhs->m_power &&
+				lhs->m_value == rhs->m_value &&
+				Equal(lhs->m_leftOperand, rhs->m_leftOperand, equal) &&
+				Equal(lhs->m_rightOperand, rhs->m_rightOperand, equal);
+			if (same) equal.emplace(lhs, rhs);
+			return same;
+		}
+	};
+
+	template <>
+	struct Hasher<DynamicExpression>
+	{
+		static inline size_t Get(const DynamicExpression & expr)
+		{
+			return NodeHasher::Get(expr.m_node);
+		}
+	};
+	template <>
+	struct Hasher<AnyExpression>
+	{
+		static inline size_t Get(const AnyExpression & expr)
+		{
+			return expr.hash();
+		}
+	};
+	template <class T, typename V>
+	struct Hasher<BindView<T, V> >
+	{
+		static inline size_t Get(const BindView<T, V> & expr)
+		{
+			return EnvironmentHash(HashCombine((size_t)HashTag::Bound, Hasher<T>::Get(expr.m_expr)), expr.m_environment);
+		}
+	};
+
+	template <class T1, class T2>
+	struct Equality
+	{
+		static inline bool Get(const T1 &, const T2 &)
+		{
+			return false;
+		}
+	};
+	template <class T1, class T2>
+	struct Equality<Expression<T1>, T2> : Equality<T1, T2>
+	{
+	};
+	template <class T1, class T2>
+	struct Equality<T1, Expression<T2> > : Equality<T1, T2>
+	{
+	};
+	template <class T1, class T2>
+	struct Equality<Expression<T1>, Expression<T2> > : Equality<T1, T2>
+	{
+	};
+	template <typename T>
+	struct Equality<Numeric<T>, Numeric<T> >
+	{
+		static inline bool Get(const Numeric<T> & lhs, const Numeric<T> & rhs)
+		{
+			return lhs.m_value == rhs.m_value;
+		}
+	};
+	template <typename T, intmax_t N, intmax_t D>
+	struct Equality<Constant<T, N, D>, Constant<T, N, D> >
+	{
+		static inline bool Get(const Constant<T, N, D> &, const Constant<T, N, D> &)
+		{
+			return true;
+		}
+	};
+	template <char id>
+	struct Equality<Variable<id>, Variable<id> >
+	{
+		static inline bool Get(const Variable<id> &, const Variable<id> &)
+		{
+			return true;
+		}
+	};
+	template <class Operator, class Operand>
+	struct Equality<UnaryExpression<Operator, Operand>, UnaryExpression<Operator, Operand> >
+	{
+		static inline bool Get(const UnaryExpression<Operator, Operand> & lhs, const UnaryExpression<Operator, Operand> & rhs)
+		{
+			return Equality<Operand, Operand>::Get(lhs.m_operand, rhs.m_operand);
+		}
+	};
+	template <class Operator, class Operand>
+	struct Equality<PostfixExpression<Operator, Operand>, PostfixExpression<Operator, Operand> >
+	{
+		static inline bool Get(const PostfixExpression<Operator, Operand> & lhs, const PostfixExpression<Operator, Operand> & rhs)
+		{
+			return Equality<Operand, Operand>::Get(lhs.m_operand, rhs.m_operand);
+		}
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct Equality<BinarryExpression<Operator, LeftOperand, RightOperand>, BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		static inline bool Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & lhs, const BinarryExpression<Operator, LeftOperand, RightOperand> & rhs)
+		{
+			return Equality<LeftOperand, LeftOperand>::Get(lhs.m_leftOperand, rhs.m_leftOperand) &&
+				Equality<RightOperand, RightOperand>::Get(lhs.m_rightOperand, rhs.m_rightOperand);
+		}
+	};
+	template <class F, class T>
+	struct Equality<FunctionExpression<F, T>, FunctionExpression<F, T> >
+	{
+		static inline bool Get(const FunctionExpression<F, T> & lhs, const FunctionExpression<F, T> & rhs)
+		{
+			return Equality<T, T>::Get(lhs.m_operand, rhs.m_operand);
+		}
+	};
+	template <>
+	struct Equality<DynamicExpression, DynamicExpression>
+	{
+		static inline bool Get(const DynamicExpression & lhs, const DynamicExpression & rhs)
+		{
+			return NodeHasher::Equal(lhs.m_node, rhs.m_node);
+		}
+	};
+	template <>
+	struct Equality<AnyExpression, AnyExpression>
+	{
+		static inline bool Get(const AnyExpression & lhs, const AnyExpression & rhs)
+		{
+			return lhs.equal(rhs);
+		}
+	};
+	template <class T, typename V>
+	struct Equality<BindView<T, V>, BindView<T, V> >
+	{
+		static inline bool Get(const BindView<T, V> & lhs, const BindView<T, V> & rhs)
+		{
+			return EnvironmentEqual(lhs.m_environment, rhs.m_environment) && Equality<T, T>::Get(lhs.m_expr, rhs.m_expr);
+		}
+	};
+
+	template <class T>
+	static inline size_t structural_hash(const Expression<T> & expr)
+	{
+		return Hasher<T>::Get(expr());
+	}
+
+	template <class T1, class T2>
+	static inline bool structural_equal(const Expression<T1> & lhs, const Expression<T2> & rhs)
+	{
+		return Equality<T1, T2>::Get(lhs(), rhs());
+	}
+
+	struct ImageHeader
+	{
+		static constexpr std::uint16_t version = 1;
+		static constexpr std::uint32_t endianness = 0x01020304;
+
+		char m_magic[4];
+		std::uint16_t m_version;
+		std::uint16_t m_flags;
+		std::uint32_t m_endianness;
+		std::uint32_t m_valueSize;
+		std::uint32_t m_nodeCount;
+		std::uint32_t m_constantCount;
+		std::uint32_t m_root;
+		std::uint32_t m_constantOffset;
+	};
+
+	struct ImageNode
+	{
+		std::uint8_t m_opcode;
+		char m_id;
+		std::uint16_t m_reserved;
+		std::int32_t m_argument;
+		std::uint32_t m_leftOperand;
+		std::uint32_t m_rightOperand;
+	};
+
+	struct ImageOpcode
+	{
+		static inline int Arity(NodeKind kind)
+		{
+			switch (kind)
+			{
+			case NodeKind::Value:
+			case NodeKind::Constant:
+			case NodeKind::Variable:
+				return 0;
+			case NodeKind::Addition:
+			case NodeKind::Subtraction:
+			case NodeKind::Multiplication:
+			case NodeKind::Division:
+			case NodeKind::RealPower:
+				return 2;
+			default:
+				return 1;
+			}
+		}
+	};
+
+	struct ImageWriter
+	{
+		static constexpr std::uint16_t shared = 1;
+
+		ImageWriter(bool share)
+			: m_share(share)
+		{
+		}
+
+		void Write(const Node * root, std::vector<char> & output)
+		{
+			std::uint32_t index = Add(root);
+			Fuse();
+			size_t nodes = sizeof(ImageHeader) + m_nodes.size() * sizeof(ImageNode);
+			size_t constants = (nodes + alignof(long double) - 1) / alignof(long double) * alignof(long double);
+			output.assign(constants + m_constants.size() * sizeof(long double), 0);
+			ImageHeader header{ { 'Z', 'N', 'C', 'B' }, ImageHeader::version, m_share ? shared : (std::uint16_t)0, ImageHeader::endianness, (std::uint32_t)sizeof(long double), (std::uint32_t)m_nodes.size(), (std::uint32_t)m_constants.size(), index, (std::uint32_t)constants };
+			std::memcpy(output.data(), &header, sizeof(header));
+			if (!m_nodes.empty()) std::memcpy(output.data() + sizeof(header), m_nodes.data(), m_nodes.size() * sizeof(ImageNode));
+			if (!m_constants.empty()) std::memcpy(output.data() + constants, m_constants.data(), m_constants.size() * sizeof(long double));
+		}
+
+		std::uint32_t Add(const Node * node)
+		{
+			auto visited = m_visited.find(node);
+			if (visited != m_visited.end()) return visited->second;
+			ImageNode image{ (std::uint8_t)node->m_kind, 0, 0, 0, 0, 0 };
+			switch (node->m_kind)
+			{
+			case NodeKind::Value:
+			case NodeKind::Constant:
+				image.m_argument = (std::int32_t)Constant(node->m_value);
+				break;
+			case NodeKind::Variable:
+				image.m_id = node->m_id;
+				break;
+			default:
+				image.m_argument = node->m_kind == NodeKind::Power ? node->m_power : 0;
+				image.m_leftOperand = Add(node->m_leftOperand);
+				if (ImageOpcode::Arity(node->m_kind) == 2) image.m_rightOperand = Add(node->m_rightOperand);
+				break;
+			}
+			std::uint32_t index = Insert(image);
+			m_visited.emplace(node, index);
+			return index;
+		}
+
+		void Fuse()
+		{
+			std::unordered_map<std::uint64_t, std::uint32_t> pending;
+			for (std::uint32_t i = 0; i < m_nodes.size(); ++i)
+			{
+				ImageNode & node = m_nodes[i];
+				if (node.m_opcode != (std::uint8_t)NodeKind::Sinus && node.m_opcode != (std::uint8_t)NodeKind::Cosinus) continue;
+				std::uint8_t partner = node.m_opcode == (std::uint8_t)NodeKind::Sinus ? (std::uint8_t)NodeKind::Cosinus : (std::uint8_t)NodeKind::Sinus;
+				auto found = pending.find(((std::uint64_t)partner << 32) | node.m_leftOperand);
+				if (found != pending.end())
+				{
+					node.m_rightOperand = found->second;
+					m_nodes[found->second].m_rightOperand = i;
+					pending.erase(found);
+				}
+				else
+				{
+					pending.emplace(((std::uint64_t)node.m_opcode << 32) | node.m_leftOperand, i);
+				}
+			}
+		}
+
+		const std::vector<ImageNode> & Nodes() const
+		{
+			return m_nodes;
+		}
+
+		const std::vector<long double> & Constants() const
+		{
+			return m_constants;
+		}
+
+	private:
+		std::uint32_t Constant(long double value)
+		{
+			auto range = m_constantIndex.equal_range(value);
+			for (auto i = range.first; i != range.second; ++i)
+			{
+				if (std::signbit(m_constants[i->second]) == std::signbit(value)) return i->second;
+			}
+			m_constants.push_back(value);
+			m_constantIndex.emplace(value, (std::uint32_t)(m_constants.size() - 1));
+			return (std::uint32_t)(m_constants.size() - 1);
+		}
+
+		std::uint32_t Insert(const ImageNode & node)
+		{
+			size_t hash = 0;
+			if (m_share)
+			{
+				hash = HashCombine(HashCombine(HashCombine(node.m_opcode, (size_t)(unsigned char)node.m_id), (size_t)(std::uint32_t)node.m_argument), HashCombine(node.m_leftOperand, node.m_rightOperand));
+				auto range = m_nodeIndex.equal_range(hash);
+				for (auto i = range.first; i != range.second; ++i)
+				{
+					const ImageNode & other = m_nodes[i->second];
+					if (other.m_opcode == node.m_opcode && other.m_id == node.m_id && other.m_argument == node.m_argument && other.m_leftOperand == node.m_leftOperand && other.m_rightOperand == node.m_rightOperand) return i->second;
+				}
+			}
+			m_nodes.push_back(node);
+			if (m_share) m_nodeIndex.emplace(hash, (std::uint32_t)(m_nodes.size() - 1));
+			return (std::uint32_t)(m_nodes.size() - 1);
+		}
+
+		bool m_share;
+		std::vector<ImageNode> m_nodes;
+		std::vector<long double> m_constants;
+		std::unordered_multimap<size_t, std::uint32_t> m_nodeIndex;
+		std::unordered_multimap<long double, std::uint32_t> m_constantIndex;
+		std::unordered_map<const Node *, std::uint32_t> m_visited;
+	};
+
+	struct ImageEvaluator
+	{
+		static inline void Run(const ImageNode * nodes, size_t count, const long double * constants, const DynamicEnvironment & env, long double * scratch)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const ImageNode & node = nodes[i];
+				NodeKind kind = (NodeKind)node.m_opcode;
+				if ((kind == NodeKind::Sinus || kind == NodeKind::Cosinus) && node.m_rightOperand != 0)
+				{
+					if (node.m_rightOperand < i) continue;
+					auto both = sincos(scratch[node.m_leftOperand]);
+					scratch[i] = kind == NodeKind::Sinus ? both.first : both.second;
+					scratch[node.m_rightOperand] = kind == NodeKind::Sinus ? both.second : both.first;
+					continue;
+				}
+				int arity = ImageOpcode::Arity(kind);
+				long double lhs = arity >= 1 ? scratch[node.m_leftOperand] : 0;
+				long double rhs = arity == 2 ? scratch[node.m_rightOperand] : 0;
+				scratch[i] = Apply(node, constants, env, lhs, rhs);
+			}
+		}
+
+		static inline long double Apply(const ImageNode & node, const long double * constants, const DynamicEnvironment & env, long double lhs, long double rhs)
+		{
+			switch ((NodeKind)node.m_opcode)
+			{
+			case NodeKind::Value:
+			case NodeKind::Constant:
+				return constants[node.m_argument];
+			case NodeKind::Variable:
+				return env.Get(node.m_id);
+			case NodeKind::Minus:
+				return -lhs;
+			case NodeKind::Increment:
+				return lhs + 1;
+			case NodeKind::Decrement:
+				return lhs - 1;
+			case NodeKind::Addition:
+				return lhs + rhs;
+			case NodeKind::Subtraction:
+				return lhs - rhs;
+			case NodeKind::Multiplication:
+				return lhs * rhs;
+			case NodeKind::Division:
+				return lhs / rhs;
+			case NodeKind::Power:
+				return NodeEvaluator::Power(lhs, node.m_argument);
+			case NodeKind::Sinus:
+				return Sinus()(lhs);
+			case NodeKind::Cosinus:
+				return Cosinus()(lhs);
+			case NodeKind::SquareRoot:
+				return std::sqrt(lhs);
+			case NodeKind::Logarithm:
+				return std::log(lhs);
+			case NodeKind::RealPower:
+				return std::pow(lhs, rhs);
+			}
+			return std::numeric_limits<long double>::quiet_NaN();
+		}
+	};
+
+	struct ExpressionImage
+	{
+		ExpressionImage()
+			: m_header(nullptr),
+			m_nodes(nullptr),
+			m_constants(nullptr)
+		{
+		}
+
+		bool Load(const void * data, size_t size)
+		{
+			m_header = nullptr;
+			const char * bytes = static_cast<const char *>(data);
+			if (!bytes || size < sizeof(ImageHeader) || reinterpret_cast<std::uintptr_t>(bytes) % alignof(long double) != 0) return false;
+			const ImageHeader * header = reinterpret_cast<const ImageHeader *>(bytes);
+			if (std::memcmp(header->m_magic, "ZNCB", 4) != 0 || header->m_version != ImageHeader::version) return false;
+			if (header->m_endianness != ImageHeader::endianness || header->m_valueSize != sizeof(long double)) return false;
+			if (header->m_nodeCount == 0 || header->m_root >= header->m_nodeCount || header->m_constantOffset % alignof(long double) != 0) return false;
+			if (sizeof(ImageHeader) + (std::uint64_t)header->m_nodeCount * sizeof(ImageNode) > header->m_constantOffset) return false;
+			if (header->m_constantOffset + (std::uint64_t)header->m_constantCount * sizeof(long double) > size) return false;
+			const ImageNode * nodes = reinterpret_cast<const ImageNode *>(bytes + sizeof(ImageHeader));
+			for (std::uint32_t i = 0; i < header->m_nodeCount; ++i)
+			{
+				const ImageNode & node = nodes[i];
+				if (node.m_opcode > (std::uint8_t)NodeKind::RealPower) return false;
+				NodeKind kind = (NodeKind)node.m_opcode;
+				int arity = ImageOpcode::Arity(kind);
+				if ((kind == NodeKind::Value || kind == NodeKind::Constant) && (std::uint32_t)node.m_argument >= header->m_constantCount) return false;
+				if (arity >= 1 && node.m_leftOperand >= i) return false;
+				if (arity == 2 && node.m_rightOperand >= i) return false;
+				if ((kind == NodeKind::Sinus || kind == NodeKind::Cosinus) && node.m_rightOperand != 0)
+				{
+					if (node.m_rightOperand >= header->m_nodeCount || node.m_rightOperand == i) return false;
+					const ImageNode & partner = nodes[node.m_rightOperand];
+					NodeKind complement = kind == NodeKind::Sinus ? NodeKind::Cosinus : NodeKind::Sinus;
+					if (partner.m_opcode != (std::uint8_t)complement || partner.m_leftOperand != node.m_leftOperand || partner.m_rightOperand != i) return false;
+				}
+			}
+			m_header = header;
+			m_nodes = nodes;
+			m_constants = reinterpret_cast<const long double *>(bytes + header->m_constantOffset);
+			return true;
+		}
+
+		size_t Size() const
+		{
+			return m_header ? m_header->m_nodeCount : 0;
+		}
+
+		long double operator()(const DynamicEnvironment & env) const
+		{
+			return m_header ? Get(m_header->m_root, env) : std::numeric_limits<long double>::quiet_NaN();
+		}
+
+		long double operator()(const DynamicEnvironment & env, long double * scratch) const
+		{
+			if (!m_header) return std::numeric_limits<long double>::quiet_NaN();
+			ImageEvaluator::Run(m_nodes, m_header->m_nodeCount, m_constants, env, scratch);
+			return scratch[m_header->m_root];
+		}
+
+	private:
+		long double Get(std::uint32_t index, const DynamicEnvironment & env) const
+		{
+			const ImageNode & node = m_nodes[index];
+			int arity = ImageOpcode::Arity((NodeKind)node.m_opcode);
+			long double lhs = arity >= 1 ? Get(node.m_leftOperand, env) : 0;
+			long double rhs = arity == 2 ? Get(node.m_rightOperand, env) : 0;
+			return ImageEvaluator::Apply(node, m_constants, env, lhs, rhs);
+		}
+
+		const ImageHeader * m_header;
+		const ImageNode * m_nodes;
+		const long double * m_constants;
+	};
+
+	template <class T>
+	static inline void serialize(const Expression<T> & expr, std::vector<char> & output, bool share = true)
+	{
+		Arena arena;
+		ImageWriter writer(share);
+		writer.Write(NodeBuilder<T>::Build(expr(), arena), output);
+	}
+
+	template <size_t count>
+	struct MultiExpression
+	{
+		static_assert(count > 0, "at least one expression is required");
+
+		template <class... Ts>
+		MultiExpression(const Expression<Ts> &... exprs)
+		{
+			static_assert(sizeof...(Ts) == count, "expression count does not match");
+			Arena arena;
+			ImageWriter writer(true);
+			const Node * roots[] = { NodeBuilder<Ts>::Build(exprs(), arena)... };
+			for (size_t i = 0; i < count; ++i) m_roots[i] = writer.Add(roots[i]);
+			writer.Fuse();
+			m_nodes = writer.Nodes();
+			m_constants = writer.Constants();
+		}
+
+		size_t Size() const
+		{
+			return m_nodes.size();
+		}
+
+		std::array<long double, count> operator()(const DynamicEnvironment & env) const
+		{
+			std::vector<long double> scratch(m_nodes.size());
+			return (*this)(env, scratch.data());
+		}
+
+		std::array<long double, count> operator()(const DynamicEnvironment & env, long double * scratch) const
+		{
+			ImageEvaluator::Run(m_nodes.data(), m_nodes.size(), m_constants.data(), env, scratch);
+			std::array<long double, count> result;
+			for (size_t i = 0; i < count; ++i) result[i] = scratch[m_roots[i]];
+			return result;
+		}
+
+	private:
+		std::vector<ImageNode> m_nodes;
+		std::vector<long double> m_constants;
+		std::array<std::uint32_t, count> m_roots;
+	};
+
+	template <class... Ts>
+	static inline std::array<long double, sizeof...(Ts)> evaluate_many(const DynamicEnvironment & point, const Expression<Ts> &... exprs)
+	{
+		return MultiExpression<sizeof...(Ts)>(exprs...)(point);
+	}
+
+	struct CostModel
+	{
+		CostModel()
+		{
+			std::fill(std::begin(m_costs), std::end(m_costs), 0u);
+			Set(NodeKind::Minus, 1).Set(NodeKind::Increment, 1).Set(NodeKind::Decrement, 1);
+			Set(NodeKind::Addition, 1).Set(NodeKind::Subtraction, 1).Set(NodeKind::Multiplication, 1);
+			Set(NodeKind::Division, 8).Set(NodeKind::SquareRoot, 8);
+			Set(NodeKind::Sinus, 40).Set(NodeKind::Cosinus, 40);
+			Set(NodeKind::Logarithm, 30).Set(NodeKind::RealPower, 60);
+		}
+
+		CostModel & Set(NodeKind kind, unsigned cost)
+		{
+			m_costs[(size_t)kind] = cost;
+			return *this;
+		}
+
+		unsigned Get(const Node * node) const
+		{
+			if (node->m_kind != NodeKind::Power) return m_costs[(size_t)node->m_kind];
+			unsigned n = node->m_power < 0 ? 0u - (unsigned)node->m_power : (unsigned)node->m_power;
+			unsigned multiplications = 0;
+			for (unsigned bits = n; bits > 1; bits >>= 1) multiplications += (bits & 1) ? 2 : 1;
+			return multiplications * m_costs[(size_t)NodeKind::Multiplication] + (node->m_power < 0 ? m_costs[(size_t)NodeKind::Division] : 0);
+		}
+
+		unsigned m_costs[(size_t)NodeKind::RealPower + 1];
+	};
+
+	struct OptimizationReport
+	{
+		unsigned m_costBefore;
+		unsigned m_costAfter;
+		size_t m_nodesBefore;
+		size_t m_nodesAfter;
+		size_t m_rewrites;
+
+		operator std::string() const
+		{
+			return "cost " + std::to_string(m_costBefore) + " -> " + std::to_string(m_costAfter) +
+				", nodes " + std::to_string(m_nodesBefore) + " -> " + std::to_string(m_nodesAfter) +
+				", rewrites " + std::to_string(m_rewrites);
+		}
+	};
+
+	class NodeOptimizer
+	{
+	public:
+		NodeOptimizer(Arena & arena, const CostModel & model)
+			: m_arena(arena),
+			m_model(model),
+			m_rewrites(0),
+			m_depth(0)
+		{
+		}
+
+		// Rewrites are counted here, not in Rewrite(), so speculative candidates
+		// that lose to another candidate do not show up in the report.
+		const Node * Optimize(const Node * node)
+		{
+			auto found = m_optimized.find(node);
+			if (found != m_optimized.end()) return found->second;
+			const Node * current = node;
+			switch (ImageOpcode::Arity(node->m_kind))
+			{
+			case 0:
+				break;
+			case 1:
+			{
+				const Node * operand = Optimize(node->m_leftOperand);
+				if (operand != node->m_leftOperand) current = m_arena.Create<Node>(Node{ node->m_kind, 0, node->m_power, 0, nullptr, operand, nullptr });
+				break;
+			}
+			default:
+			{
+				const Node * lhs = Optimize(node->m_leftOperand);
+				const Node * rhs = Optimize(node->m_rightOperand);
+				if (lhs != node->m_leftOperand || rhs != node->m_rightOperand) current = NodeFactory::Binary(m_arena, node->m_kind, lhs, rhs);
+				break;
+			}
+			}
+			const Node * result = current;
+			if (ImageOpcode::Arity(node->m_kind) != 0)
+			{
+				result = Rewrite(current);
+				if (result != current) ++m_rewrites;
+			}
+			m_optimized.emplace(node, result);
+			return result;
+		}
+
+		unsigned Cost(const Node * node)
+		{
+			return Measure(node).m_cost;
+		}
+
+		size_t Count(const Node * node)
+		{
+			return Measure(node).m_nodes;
+		}
+
+		size_t Rewrites() const
+		{
+			return m_rewrites;
+		}
+
+	private:
+		static constexpr size_t candidates = 6;
+		static constexpr size_t depth = 64;
+
+		struct Score
+		{
+			unsigned m_cost;
+			size_t m_nodes;
+		};
+
+		Score Measure(const Node * node)
+		{
+			auto found = m_scores.find(node);
+			if (found != m_scores.end()) return found->second;
+			Score score{ m_model.Get(node), 1 };
+			int arity = ImageOpcode::Arity(node->m_kind);
+			if (arity >= 1)
+			{
+				Score lhs = Measure(node->m_leftOperand);
+				score.m_cost += lhs.m_cost;
+				score.m_nodes += lhs.m_nodes;
+			}
+			if (arity == 2)
+			{
+				Score rhs = Measure(node->m_rightOperand);
+				score.m_cost += rhs.m_cost;
+				score.m_nodes += rhs.m_nodes;
+			}
+			m_scores.emplace(node, score);
+			return score;
+		}
+
+		bool Better(const Node * candidate, const Node * current)
+		{
+			Score lhs = Measure(candidate);
+			Score rhs = Measure(current);
+			return lhs.m_cost < rhs.m_cost || (lhs.m_cost == rhs.m_cost && lhs.m_nodes < rhs.m_nodes);
+		}
+
+		static bool IsValue(const Node * node)
+		{
+			return node->m_kind == NodeKind::Value || node->m_kind == NodeKind::Constant;
+		}
+
+		static bool IsValue(const Node * node, long double value)
+		{
+			return node->m_kind == NodeKind::Value && node->m_value == value;
+		}
+
+		bool Same(const Node * lhs, const Node * rhs)
+		{
+			if (lhs == rhs) return true;
+			return NodeHasher::Get(lhs, m_hashes) == NodeHasher::Get(rhs, m_hashes) && NodeHasher::Equal(lhs, rhs, m_equal);
+		}
+
+		static const Node * Base(const Node * node)
+		{
+			return node->m_kind == NodeKind::Power ? node->m_leftOperand : node;
+		}
+
+		static int Exponent(const Node * node)
+		{
+			return node->m_kind == NodeKind::Power ? node->m_power : 1;
+		}
+
+		const Node * Value(long double value)
+		{
+			return NodeFactory::Value(m_arena, value);
+		}
+
+		const Node * Make(NodeKind kind, const Node * lhs, const Node * rhs = nullptr)
+		{
+			const Node * node = rhs ? NodeFactory::Binary(m_arena, kind, lhs, rhs) : NodeFactory::Unary(m_arena, kind, lhs);
+			return m_depth < depth ? Rewrite(node) : node;
+		}
+
+		const Node * MakePower(const Node * base, int p)
+		{
+			if (p == 1) return base;
+			const Node * node = NodeFactory::Power(m_arena, p, base);
+			return m_depth < depth ? Rewrite(node) : node;
+		}
+
+		const Node * Fold(const Node * node)
+		{
+			int arity = ImageOpcode::Arity(node->m_kind);
+			if (arity == 0) return node;
+			if (!IsValue(node->m_leftOperand) || (arity == 2 && !IsValue(node->m_rightOperand))) return node;
+			return Value(NodeEvaluator::Get(node, DynamicEnvironment()));
+		}
+
+		const Node * Rewrite(const Node * node)
+		{
+			const Node * folded = Fold(node);
+			if (folded != node) return folded;
+			++m_depth;
+			const Node * candidate[candidates] = {};
+			switch (node->m_kind)
+			{
+			case NodeKind::Minus:
+				RewriteMinus(node->m_leftOperand, candidate);
+				break;
+			case NodeKind::Power:
+				RewritePower(node->m_leftOperand, node->m_power, candidate);
+				break;
+			case NodeKind::Addition:
+			case NodeKind::Subtraction:
+				RewriteSum(node->m_kind, node->m_leftOperand, node->m_rightOperand, candidate);
+				break;
+			case NodeKind::Multiplication:
+				RewriteProduct(node->m_leftOperand, node->m_rightOperand, candidate);
+				break;
+			case NodeKind::Division:
+				RewriteQuotient(node->m_leftOperand, node->m_rightOperand, candidate);
+				break;
+			default:
+				break;
+			}
+			--m_depth;
+			const Node * best = node;
+			for (const Node * item : candidate)
+			{
+				if (item && Better(item, best)) best = item;
+			}
+			return best;
+		}
+
+		void RewriteMinus(const Node * operand, const Node ** candidate)
+		{
+			if (operand->m_kind == NodeKind::Minus) candidate[0] = operand->m_leftOperand;
+			if (operand->m_kind == NodeKind::Subtraction) candidate[1] = Make(NodeKind::Subtraction, operand->m_rightOperand, operand->m_leftOperand);
+		}
+
+		void RewritePower(const Node * base, int p, const Node ** candidate)
+		{
+			if (p == 1) candidate[0] = base;
+			else if (p == 0) candidate[0] = Value(1);
+			if (base->m_kind == NodeKind::Power && p > 0 && base->m_power > 0) candidate[1] = MakePower(base->m_leftOperand, p * base->m_power);
+		}
+
+		void RewriteSum(NodeKind kind, const Node * lhs, const Node * rhs, const Node ** candidate)
+		{
+			NodeKind inverse = kind == NodeKind::Addition ? NodeKind::Subtraction : NodeKind::Addition;
+			if (IsValue(rhs, 0)) candidate[0] = lhs;
+			else if (IsValue(lhs, 0)) candidate[0] = kind == NodeKind::Addition ? rhs : Make(NodeKind::Minus, rhs);
+			else if (rhs->m_kind == NodeKind::Minus) candidate[0] = Make(inverse, lhs, rhs->m_leftOperand);
+			else if (lhs->m_kind == NodeKind::Minus && kind == NodeKind::Addition) candidate[0] = Make(NodeKind::Subtraction, rhs, lhs->m_leftOperand);
+			if (kind == NodeKind::Addition && Same(lhs, rhs)) candidate[1] = Make(NodeKind::Multiplication, Value(2), lhs);
+			candidate[2] = Factor(kind, lhs, rhs);
+			if (lhs->m_kind == NodeKind::Division && rhs->m_kind == NodeKind::Division)
+			{
+				const Node * a = lhs->m_leftOperand;
+				const Node * b = lhs->m_rightOperand;
+				const Node * c = rhs->m_leftOperand;
+				const Node * d = rhs->m_rightOperand;
+				if (Same(b, d)) candidate[3] = Make(NodeKind::Division, Make(kind, a, c), b);
+				else candidate[3] = Make(NodeKind::Division, Make(kind, Make(NodeKind::Multiplication, a, d), Make(NodeKind::Multiplication, c, b)), Make(NodeKind::Multiplication, b, d));
+			}
+			else if (lhs->m_kind == NodeKind::Division)
+			{
+				const Node * b = lhs->m_rightOperand;
+				candidate[3] = Make(NodeKind::Division, Make(kind, lhs->m_leftOperand, Make(NodeKind::Multiplication, rhs, b)), b);
+			}
+			else if (rhs->m_kind == NodeKind::Division)
+			{
+				const Node * d = rhs->m_rightOperand;
+				candidate[3] = Make(NodeKind::Division, Make(kind, Make(NodeKind::Multiplication, lhs, d), rhs->m_leftOperand), d);
+			}
+		}
+
+		const Node * Factor(NodeKind kind, const Node * lhs, const Node * rhs)
+		{
+			const Node * left[2] = { lhs, nullptr };
+			const Node * right[2] = { rhs, nullptr };
+			if (lhs->m_kind == NodeKind::Multiplication)
+			{
+				left[0] = lhs->m_leftOperand;
+				left[1] = lhs->m_rightOperand;
+			}
+			if (rhs->m_kind == NodeKind::Multiplication)
+			{
+				right[0] = rhs->m_leftOperand;
+				right[1] = rhs->m_rightOperand;
+			}
+			if (!left[1] && !right[1]) return nullptr;
+			for (size_t i = 0; i < 2; ++i)
+			{
+				for (size_t j = 0; j < 2; ++j)
+				{
+					if (!left[i] || !right[j] || IsValue(left[i]) || !Same(left[i], right[j])) continue;
+					const Node * a = left[1] ? left[1 - i] : Value(1);
+					const Node * b = right[1] ? right[1 - j] : Value(1);
+					return Make(NodeKind::Multiplication, left[i], Make(kind, a, b));
+				}
+			}
+			return nullptr;
+		}
+
+		void RewriteProduct(const Node * lhs, const Node * rhs, const Node ** candidate)
+		{
+			if (IsValue(lhs, 1)) candidate[0] = rhs;
+			else if (IsValue(rhs, 1)) candidate[0] = lhs;
+			else if (IsValue(lhs, -1)) candidate[0] = Make(NodeKind::Minus, rhs);
+			else if (IsValue(rhs, -1)) candidate[0] = Make(NodeKind::Minus, lhs);
+			if (Same(Base(lhs), Base(rhs)) && Exponent(lhs) > 0 && Exponent(rhs) > 0) candidate[1] = MakePower(Base(lhs), Exponent(lhs) + Exponent(rhs));
+			if (lhs->m_kind == NodeKind::Division && rhs->m_kind == NodeKind::Division)
+			{
+				candidate[2] = Make(
+					NodeKind::Division,
+					Make(NodeKind::Multiplication, lhs->m_leftOperand, rhs->m_leftOperand),
+					Make(NodeKind::Multiplication, lhs->m_rightOperand, rhs->m_rightOperand)
+				);
+			}
+			else if (lhs->m_kind == NodeKind::Division)
+			{
+				candidate[2] = Make(NodeKind::Division, Make(NodeKind::Multiplication, lhs->m_leftOperand, rhs), lhs->m_rightOperand);
+			}
+			else if (rhs->m_kind == NodeKind::Division)
+			{
+				candidate[2] = Make(NodeKind::Division, Make(NodeKind::Multiplication, lhs, rhs->m_leftOperand), rhs->m_rightOperand);
+			}
+			if (IsValue(lhs) && rhs->m_kind == NodeKind::Multiplication)
+			{
+				if (IsValue(rhs->m_leftOperand)) candidate[3] = Make(NodeKind::Multiplication, Make(NodeKind::Multiplication, lhs, rhs->m_leftOperand), rhs->m_rightOperand);
+				else if (IsValue(rhs->m_rightOperand)) candidate[3] = Make(NodeKind::Multiplication, Make(NodeKind::Multiplication, lhs, rhs->m_rightOperand), rhs->m_leftOperand);
+			}
+			else if (IsValue(rhs) && !IsValue(lhs))
+			{
+				candidate[3] = Make(NodeKind::Multiplication, rhs, lhs);
+			}
+			if (lhs->m_kind == NodeKind::Minus) candidate[4] = Make(NodeKind::Minus, Make(NodeKind::Multiplication, lhs->m_leftOperand, rhs));
+			else if (rhs->m_kind == NodeKind::Minus) candidate[4] = Make(NodeKind::Minus, Make(NodeKind::Multiplication, lhs, rhs->m_leftOperand));
+		}
+
+		void RewriteQuotient(const Node * lhs, const Node * rhs, const Node ** candidate)
+		{
+			if (IsValue(rhs, 1))
+			{
+				candidate[0] = lhs;
+			}
+			else if (IsValue(rhs) && rhs->m_value != 0 && std::isfinite(rhs->m_value))
+			{
+				candidate[0] = Make(NodeKind::Multiplication, Value(1 / rhs->m_value), lhs);
+			}
+			if (lhs->m_kind == NodeKind::Division && rhs->m_kind == NodeKind::Division)
+			{
+				candidate[1] = Make(
+					NodeKind::Division,
+					Make(NodeKind::Multiplication, lhs->m_leftOperand, rhs->m_rightOperand),
+					Make(NodeKind::Multiplication, lhs->m_rightOperand, rhs->m_leftOperand)
+				);
+			}
+			else if (lhs->m_kind == NodeKind::Division)
+			{
+				candidate[1] = Make(NodeKind::Division, lhs->m_leftOperand, Make(NodeKind::Multiplication, lhs->m_rightOperand, rhs));
+			}
+			else if (rhs->m_kind == NodeKind::Division)
+			{
+				candidate[1] = Make(NodeKind::Division, Make(NodeKind::Multiplication, lhs, rhs->m_rightOperand), rhs->m_leftOperand);
+			}
+		}
+
+		Arena & m_arena;
+		const CostModel & m_model;
+		std::unordered_map<const Node *, Score> m_scores;
+		std::unordered_map<const Node *, const Node *> m_optimized;
+		std::unordered_map<const Node *, size_t> m_hashes;
+		std::unordered_multimap<const Node *, const Node *> m_equal;
+		size_t m_rewrites;
+		size_t m_depth;
+	};
+
+	template <class T>
+	static inline DynamicExpression optimize(const Expression<T> & expr, Arena & arena, OptimizationReport & report, const CostModel & model = CostModel())
+	{
+		NodeOptimizer optimizer(arena, model);
+		const Node * node = NodeBuilder<T>::Build(expr(), arena);
+		report.m_costBefore = optimizer.Cost(node);
+		report.m_nodesBefore = optimizer.Count(node);
+		for (size_t pass = 0; pass < 4; ++pass)
+		{
+			const Node * optimized = optimizer.Optimize(node);
+			if (optimized == node) break;
+			node = optimized;
+		}
+		report.m_costAfter = optimizer.Cost(node);
+		report.m_nodesAfter = optimizer.Count(node);
+		report.m_rewrites = optimizer.Rewrites();
+		return{ node, arena };
+	}
+
+	template <class T>
+	static inline DynamicExpression optimize(const Expression<T> & expr, Arena & arena)
+	{
+		OptimizationReport report;
+		return optimize(expr, arena, report);
+	}
+
+	template <typename F = long double>
+	struct LimitCache
+	{
+		static constexpr size_t shards = 16;
+
+		LimitCache(size_t capacity = 4096)
+			: m_capacity(capacity / shards ? capacity / shards : 1),
+			m_hits(0),
+			m_misses(0)
+		{
+		}
+
+		LimitCache(const LimitCache &) = delete;
+		LimitCache & operator=(const LimitCache &) = delete;
+
+		template <char id, typename toT, class T>
+		F lim(const LimitParam<id, toT> & param, const Expression<T> & expr)
+		{
+			const T & tree = expr();
+			F point = (F)ExpressionOperator<toT>::GetParam(param.m_to)();
+			size_t hash = HashCombine(HashCombine(Hasher<T>::Get(tree), (size_t)(unsigned char)id), std::hash<F>()(point));
+			Shard & shard = m_shards[hash % shards];
+			{
+				std::lock_guard<std::mutex> lock(shard.m_mutex);
+				auto entry = Find<T>(shard, hash, id, point, tree);
+				if (entry != shard.m_entries.end())
+				{
+					shard.m_entries.splice(shard.m_entries.begin(), shard.m_entries, entry);
+					m_hits.fetch_add(1, std::memory_order_relaxed);
+					return entry->m_value;
+				}
+			}
+			m_misses.fetch_add(1, std::memory_order_relaxed);
+			F value = Limit<id, toT, T, HasDivision<T>::value, F>::Get(param, tree);
+			std::shared_ptr<const void> copy = std::make_shared<T>(tree);
+			std::lock_guard<std::mutex> lock(shard.m_mutex);
+			if (Find<T>(shard, hash, id, point, tree) != shard.m_entries.end()) return value;
+			shard.m_entries.push_front(Entry{ hash, id, point, &TypeTag<T>::value, std::move(copy), value });
+			shard.m_index.emplace(hash, shard.m_entries.begin());
+			if (shard.m_entries.size() > m_capacity)
+			{
+				auto last = std::prev(shard.m_entries.end());
+				auto range = shard.m_index.equal_range(last->m_hash);
+				for (auto i = range.first; i != range.second; ++i)
+				{
+					if (i->second == last)
+					{
+						shard.m_index.erase(i);
+						break;
+					}
+				}
+				shard.m_entries.erase(last);
+			}
+			return value;
+		}
+
+		size_t hits() const
+		{
+			return m_hits.load(std::memory_order_relaxed);
+		}
+
+		size_t misses() const
+		{
+			return m_misses.load(std::memory_order_relaxed);
+		}
+
+		size_t size()
+		{
+			size_t result = 0;
+			for (auto & shard : m_shards)
+			{
+				std::lock_guard<std::mutex> lock(shard.m_mutex);
+				result += shard.m_entries.size();
+			}
+			return result;
+		}
+
+		void clear()
+		{
+			for (auto & shard : m_shards)
+			{
+				std::lock_guard<std::mutex> lock(shard.m_mutex);
+				shard.m_index.clear();
+				shard.m_entries.clear();
+			}
+			m_hits.store(0);
+			m_misses.store(0);
+		}
+
+	private:
+		struct Entry
+		{
+			size_t m_hash;
+			char m_id;
+			F m_point;
+			const char * m_type;
+			std::shared_ptr<const void> m_expr;
+			F m_value;
+		};
+
+		struct Shard
+		{
+			std::mutex m_mutex;
+			std::list<Entry> m_entries;
+			std::unordered_multimap<size_t, typename std::list<Entry>::iterator> m_index;
+		};
+
+		template <class T>
+		struct TypeTag
+		{
+			static char value;
+		};
+
+		template <class T>
+		static typename std::list<Entry>::iterator Find(Shard & shard, size_t hash, char id, F point, const T & tree)
+		{
+			auto range = shard.m_index.equal_range(hash);
+			for (auto i = range.first; i != range.second; ++i)
+			{
+				const Entry & entry = *i->second;
+				if (entry.m_id != id || entry.m_point != point || entry.m_type != &TypeTag<T>::value) continue;
+				if (Equality<T, T>::Get(*static_cast<const T *>(entry.m_expr.get()), tree)) return i->second;
+			}
+			return shard.m_entries.end();
+		}
+
+		size_t m_capacity;
+		Shard m_shards[shards];
+		std::atomic<size_t> m_hits;
+		std::atomic<size_t> m_misses;
+	};
+
+	template <typename F>
+	template <class T>
+	char LimitCache<F>::TypeTag<T>::value = 0;
+
+	template <typename F, char id, typename toT, class T>
+	static inline F lim(const LimitParam<id, toT> && param, const Expression<T> & expr, LimitCache<F> & cache)
+	{
+		return cache.lim(param, expr);
+	}
+
+	template <class Operator, size_t begin, size_t count>
+	struct TreeReduction
+	{
+		template <class Tuple, class F>
+		static inline auto Get(const Tuple & operands, const F & f)
+		{
+			return Operator()(
+				TreeReduction<Operator, begin, count / 2>::Get(operands, f),
+				TreeReduction<Operator, begin + count / 2, count - count / 2>::Get(operands, f)
+			);
+		}
+	};
+	template <class Operator, size_t begin>
+	struct TreeReduction<Operator, begin, 1>
+	{
+		template <class Tuple, class F>
+		static inline auto Get(const Tuple & operands, const F & f)
+		{
+			return f(std::get<begin>(operands));
+		}
+	};
+
+	template <class Operator, class... Ts>
+	struct VariadicExpression
+	{
+		VariadicExpression(Ts... operands)
+			: m_operands(std::move(operands)...)
+		{
+		}
+
+		auto Get() const
+		{
+			return TreeReduction<Operator, 0, sizeof...(Ts)>::Get(m_operands, [](const auto & operand)
+			{
+				return operand();
+			});
+		}
+
+		template <class E>
+		auto Get(const E & env) const
+		{
+			return TreeReduction<Operator, 0, sizeof...(Ts)>::Get(m_operands, [&env](const auto & operand)
+			{
+				return Evaluator<typename std::decay<decltype(operand)>::type>::Get(operand, env);
+			});
+		}
+
+		std::tuple<Ts...> m_operands;
+	};
+
+	template <class... Ts>
+	struct Sum : Expression<Sum<Ts...> >, VariadicExpression<Addition, Ts...>
+	{
+		Sum(Ts... operands)
+			: VariadicExpression<Addition, Ts...>(std::move(operands)...)
+		{
+		}
+
+		auto operator()() const
+		{
+			return this->Get();
+		}
+
+		operator std::string() const
+		{
+			return print(*this);
+		}
+	};
+
+	template <class... Ts>
+	struct Product : Expression<Product<Ts...> >, VariadicExpression<Multiplication, Ts...>
+	{
+		Product(Ts... operands)
+			: VariadicExpression<Multiplication, Ts...>(std::move(operands)...)
+		{
+		}
+
+		auto operator()() const
+		{
+			return this->Get();
+		}
+
+		operator std::string() const
+		{
+			return print(*this);
+		}
+	};
+
+	template <class... Ts>
+	struct VariablesOf;
+	template <>
+	struct VariablesOf<>
+	{
+		typedef VariableList<> type;
+	};
+	template <class T, class... Ts>
+	struct VariablesOf<T, Ts...>
+	{
+		typedef typename VariableListUnion<typename Variables<T>::type, typename VariablesOf<Ts...>::type>::type type;
+	};
+
+	template <class... Ts>
+	struct Variables<Sum<Ts...> > : VariablesOf<Ts...>
+	{
+	};
+	template <class... Ts>
+	struct Variables<Product<Ts...> > : VariablesOf<Ts...>
+	{
+	};
+
+	template <class... Ts>
+	struct AnyOf;
+	template <>
+	struct AnyOf<>
+	{
+		static constexpr bool value = false;
+	};
+	template <class T, class... Ts>
+	struct AnyOf<T, Ts...>
+	{
+		static constexpr bool value = T::value || AnyOf<Ts...>::value;
+	};
+
+	template <class... Ts>
+	struct HasVariables<Sum<Ts...> > : AnyOf<HasVariables<Ts>...>
+	{
+	};
+	template <class... Ts>
+	struct HasVariables<Product<Ts...> > : AnyOf<HasVariables<Ts>...>
+	{
+	};
+	template <class... Ts>
+	struct HasDivision<Sum<Ts...> > : AnyOf<HasDivision<Ts>...>
+	{
+	};
+	template <class... Ts>
+	struct HasDivision<Product<Ts...> > : AnyOf<HasDivision<Ts>...>
+	{
+	};
+
+	template <class... Ts>
+	struct Evaluator<Sum<Ts...> >
+	{
+		template <class E>
+		static inline auto Get(const Sum<Ts...> & expr, const E & env)
+		{
+			return expr.Get(env);
+		}
+	};
+	template <class... Ts>
+	struct Evaluator<Product<Ts...> >
+	{
+		template <class E>
+		static inline auto Get(const Product<Ts...> & expr, const E & env)
+		{
+			return expr.Get(env);
+		}
+	};
+
+	template <template <class...> class Node, class S, class T1, class T2, class... Ts>
+	struct VariadicBinder;
+	template <template <class...> class Node, size_t... i, class T1, class T2, class... Ts>
+	struct VariadicBinder<Node, std::index_sequence<i...>, T1, T2, Ts...>
+	{
+		typedef Node<typename Binder<Ts, T1, T2>::type...> type;
+		static inline type Bind(const Node<Ts...> & exp, const T1 & var, const T2 & value)
+		{
+			return type(Binder<Ts, T1, T2>::Bind(std::get<i>(exp.m_operands), var, value)...);
+		}
+	};
+
+	template <class T1, class T2, class... Ts>
+	struct Binder<Sum<Ts...>, T1, T2> : VariadicBinder<Sum, std::index_sequence_for<Ts...>, T1, T2, Ts...>
+	{
+	};
+	template <class T1, class T2, class... Ts>
+	struct Binder<Product<Ts...>, T1, T2> : VariadicBinder<Product, std::index_sequence_for<Ts...>, T1, T2, Ts...>
+	{
+	};
+
+	template <class S, class... Ts>
+	struct SumDerivation;
+	template <size_t... i, class... Ts>
+	struct SumDerivation<std::index_sequence<i...>, Ts...>
+	{
+		typedef Sum<typename Derivation<Ts>::type...> type;
+		static inline type Derive(const Sum<Ts...> & exp)
+		{
+			return type(Derivation<Ts>::Derive(std::get<i>(exp.m_operands))...);
+		}
+	};
+
+	template <class... Ts>
+	struct Derivation<Sum<Ts...> > : SumDerivation<std::index_sequence_for<Ts...>, Ts...>
+	{
+	};
+
+	template <size_t i, size_t j, class T>
+	struct ProductFactor
+	{
+		typedef T type;
+		static inline const T & Get(const T & exp)
+		{
+			return exp;
+		}
+	};
+	template <size_t i, class T>
+	struct ProductFactor<i, i, T>
+	{
+		typedef typename Derivation<T>::type type;
+		static inline type Get(const T & exp)
+		{
+			return Derivation<T>::Derive(exp);
+		}
+	};
+
+	template <size_t i, class S, class... Ts>
+	struct ProductTerm;
+	template <size_t i, size_t... j, class... Ts>
+	struct ProductTerm<i, std::index_sequence<j...>, Ts...>
+	{
+		typedef Product<typename ProductFactor<i, j, Ts>::type...> type;
+		static inline type Get(const Product<Ts...> & exp)
+		{
+			return type(ProductFactor<i, j, Ts>::Get(std::get<j>(exp.m_operands))...);
+		}
+	};
+
+	template <class S, class... Ts>
+	struct ProductDerivation;
+	template <size_t... i, class... Ts>
+	struct ProductDerivation<std::index_sequence<i...>, Ts...>
+	{
+		typedef Sum<typename ProductTerm<i, std::index_sequence_for<Ts...>, Ts...>::type...> type;
+		static inline type Derive(const Product<Ts...> & exp)
+		{
+			return type(ProductTerm<i, std::index_sequence_for<Ts...>, Ts...>::Get(exp)...);
+		}
+	};
+
+	template <class... Ts>
+	struct Derivation<Product<Ts...> > : ProductDerivation<std::index_sequence_for<Ts...>, Ts...>
+	{
+	};
+
+	template <class Operator, class... Ts>
+	struct VariadicHasher
+	{
+		template <size_t... i>
+		static inline size_t Get(const std::tuple<Ts...> & operands, std::index_sequence<i...>)
+		{
+			size_t seed = HashCombine((size_t)HashTag::Variadic, OperatorHash<Operator>::Get());
+			std::initializer_list<int>{ (seed = HashCombine(seed, Hasher<Ts>::Get(std::get<i>(operands))), 0)... };
+			return seed;
+		}
+
+		template <size_t... i>
+		static inline bool Equal(const std::tuple<Ts...> & lhs, const std::tuple<Ts...> & rhs, std::index_sequence<i...>)
+		{
+			bool result = true;
+			std::initializer_list<int>{ (result = result && Equality<Ts, Ts>::Get(std::get<i>(lhs), std::get<i>(rhs)), 0)... };
+			return result;
+		}
+	};
+
+	template <class... Ts>
+	struct Hasher<Sum<Ts...> >
+	{
+		static inline size_t Get(const Sum<Ts...> & expr)
+		{
+			return VariadicHasher<Addition, Ts...>::Get(expr.m_operands, std::index_sequence_for<Ts...>());
+		}
+	};
+	template <class... Ts>
+	struct Hasher<Product<Ts...> >
+	{
+		static inline size_t Get(const Product<Ts...> & expr)
+		{
+			return VariadicHasher<Multiplication, Ts...>::Get(expr.m_operands, std::index_sequence_for<Ts...>());
+		}
+	};
+	template <class... Ts>
+	struct Equality<Sum<Ts...>, Sum<Ts...> >
+	{
+		static inline bool Get(const Sum<Ts...> & lhs, const Sum<Ts...> & rhs)
+		{
+			return VariadicHasher<Addition, Ts...>::Equal(lhs.m_operands, rhs.m_operands, std::index_sequence_for<Ts...>());
+		}
+	};
+	template <class... Ts>
+	struct Equality<Product<Ts...>, Product<Ts...> >
+	{
+		static inline bool Get(const Product<Ts...> & lhs, const Product<Ts...> & rhs)
+		{
+			return VariadicHasher<Multiplication, Ts...>::Equal(lhs.m_operands, rhs.m_operands, std::index_sequence_for<Ts...>());
+		}
+	};
+
+	template <class Operator, class... Ts>
+	struct VariadicWriter
+	{
+		template <class Format, class Sink>
+		static inline void Write(const std::tuple<Ts...> & operands, Sink & sink)
+		{
+			Write<Format>(operands, sink, std::index_sequence_for<Ts...>());
+		}
+
+		template <class Format, class Sink, size_t... i>
+		static inline void Write(const std::tuple<Ts...> & operands, Sink & sink, std::index_sequence<i...>)
+		{
+			typedef void(*Item)(const std::tuple<Ts...> &, Sink &);
+			static const Item items[] = { &Operand<Format, Sink, i>... };
+			Notation<Format, Operator>::Variadic(sink, Operator(), sizeof...(Ts), [&](size_t index) { items[index](operands, sink); });
+		}
+
+		template <class Format, class Sink, size_t i>
+		static void Operand(const std::tuple<Ts...> & operands, Sink & sink)
+		{
+			typedef typename std::tuple_element<i, std::tuple<Ts...> >::type type;
+			Writer<type>::template Write<Format>(std::get<i>(operands), sink);
+		}
+	};
+
+	template <class... Ts>
+	struct Writer<Sum<Ts...> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const Sum<Ts...> & expr, Sink & sink)
+		{
+			VariadicWriter<Addition, Ts...>::template Write<Format>(expr.m_operands, sink);
+		}
+	};
+	template <class... Ts>
+	struct Writer<Product<Ts...> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const Product<Ts...> & expr, Sink & sink)
+		{
+			VariadicWriter<Multiplication, Ts...>::template Write<Format>(expr.m_operands, sink);
+		}
+	};
+
+	template <class Operator, class... Ts>
+	struct VariadicNodeBuilder
+	{
+		template <size_t... i>
+		static inline const Node * Build(const std::tuple<Ts...> & operands, Arena & arena, std::index_sequence<i...>)
+		{
+			const Node * nodes[] = { NodeBuilder<Ts>::Build(std::get<i>(operands), arena)... };
+			return Reduce(nodes, 0, sizeof...(Ts), arena);
+		}
+
+		static inline const Node * Reduce(const Node * const * nodes, size_t begin, size_t count, Arena & arena)
+		{
+			if (count == 1) return nodes[begin];
+			return NodeFactory::Binary(
+				arena,
+				NodeOperator<Operator>::kind,
+				Reduce(nodes, begin, count / 2, arena),
+				Reduce(nodes, begin + count / 2, count - count / 2, arena)
 			);
 		}
 	};
 
-	template <size_t terms, class T>
-	static inline auto expand(const T & exp)
+	template <class... Ts>
+	struct NodeBuilder<Sum<Ts...> >
+	{
+		static inline const Node * Build(const Sum<Ts...> & expr, Arena & arena)
+		{
+			return VariadicNodeBuilder<Addition, Ts...>::Build(expr.m_operands, arena, std::index_sequence_for<Ts...>());
+		}
+	};
+	template <class... Ts>
+	struct NodeBuilder<Product<Ts...> >
+	{
+		static inline const Node * Build(const Product<Ts...> & expr, Arena & arena)
+		{
+			return VariadicNodeBuilder<Multiplication, Ts...>::Build(expr.m_operands, arena, std::index_sequence_for<Ts...>());
+		}
+	};
+
+	static constexpr std::uint64_t KeyMix(std::uint64_t seed, std::uint64_t value)
+	{
+		return (seed ^ value) * 0x100000001b3ULL;
+	}
+
+	template <class Operator>
+	struct OperatorKey
+	{
+		static constexpr std::uint64_t value = 0;
+	};
+	template <>
+	struct OperatorKey<UnaryMinus>
+	{
+		static constexpr std::uint64_t value = 1;
+	};
+	template <>
+	struct OperatorKey<UnaryAddition>
+	{
+		static constexpr std::uint64_t value = 2;
+	};
+	template <>
+	struct OperatorKey<UnarySubtraction>
+	{
+		static constexpr std::uint64_t value = 3;
+	};
+	template <>
+	struct OperatorKey<Addition>
+	{
+		static constexpr std::uint64_t value = 4;
+	};
+	template <>
+	struct OperatorKey<Subtraction>
+	{
+		static constexpr std::uint64_t value = 5;
+	};
+	template <>
+	struct OperatorKey<Multiplication>
+	{
+		static constexpr std::uint64_t value = 6;
+	};
+	template <>
+	struct OperatorKey<Division>
+	{
+		static constexpr std::uint64_t value = 7;
+	};
+	template <int p>
+	struct OperatorKey<Power<p> >
+	{
+		static constexpr std::uint64_t value = KeyMix(8, (std::uint64_t)p);
+	};
+	template <>
+	struct OperatorKey<IntegerPower>
+	{
+		static constexpr std::uint64_t value = 9;
+	};
+	template <>
+	struct OperatorKey<RealPower>
+	{
+		static constexpr std::uint64_t value = 10;
+	};
+	template <>
+	struct OperatorKey<Sinus>
+	{
+		static constexpr std::uint64_t value = 11;
+	};
+	template <>
+	struct OperatorKey<Cosinus>
+	{
+		static constexpr std::uint64_t value = 12;
+	};
+	template <>
+	struct OperatorKey<SquareRoot>
+	{
+		static constexpr std::uint64_t value = 13;
+	};
+	template <>
+	struct OperatorKey<Logarithm>
+	{
+		static constexpr std::uint64_t value = 14;
+	};
+
+	template <std::uint64_t rank, std::uint64_t key>
+	struct OrderKey
+	{
+		static constexpr std::uint64_t value = (rank << 56) | (key & ((1ULL << 56) - 1));
+	};
+
+	template <class T>
+	struct TypeKey : OrderKey<4, 0>
+	{
+	};
+	template <class T>
+	struct TypeKey<Expression<T> > : TypeKey<T>
+	{
+	};
+	template <typename T>
+	struct TypeKey<Numeric<T> > : OrderKey<0, 0>
+	{
+	};
+	template <typename T, intmax_t N, intmax_t D>
+	struct TypeKey<Constant<T, N, D> > : OrderKey<0, KeyMix((std::uint64_t)N, (std::uint64_t)D)>
+	{
+	};
+	template <char id>
+	struct TypeKey<Variable<id> > : OrderKey<1, (unsigned char)id>
+	{
+	};
+	template <class Operator, class Operand>
+	struct TypeKey<UnaryExpression<Operator, Operand> > : OrderKey<3, KeyMix(KeyMix(1, OperatorKey<Operator>::value), TypeKey<Operand>::value)>
+	{
+	};
+	template <class Operator, class Operand>
+	struct TypeKey<PostfixExpression<Operator, Operand> > : OrderKey<2, KeyMix(KeyMix(2, OperatorKey<Operator>::value), TypeKey<Operand>::value)>
+	{
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct TypeKey<BinarryExpression<Operator, LeftOperand, RightOperand> >
+		: OrderKey<3, KeyMix(KeyMix(KeyMix(3, OperatorKey<Operator>::value), TypeKey<LeftOperand>::value), TypeKey<RightOperand>::value)>
+	{
+	};
+	template <class F, class T>
+	struct TypeKey<FunctionExpression<F, T> > : OrderKey<3, KeyMix(KeyMix(4, OperatorKey<F>::value), TypeKey<T>::value)>
+	{
+	};
+
+	template <std::uint64_t seed, class... Ts>
+	struct TypeKeyFold;
+	template <std::uint64_t seed>
+	struct TypeKeyFold<seed>
+	{
+		static constexpr std::uint64_t value = seed;
+	};
+	template <std::uint64_t seed, class T, class... Ts>
+	struct TypeKeyFold<seed, T, Ts...> : TypeKeyFold<KeyMix(seed, TypeKey<T>::value), Ts...>
+	{
+	};
+
+	template <class... Ts>
+	struct TypeKey<Sum<Ts...> > : OrderKey<3, TypeKeyFold<KeyMix(5, OperatorKey<Addition>::value), Ts...>::value>
+	{
+	};
+	template <class... Ts>
+	struct TypeKey<Product<Ts...> > : OrderKey<3, TypeKeyFold<KeyMix(5, OperatorKey<Multiplication>::value), Ts...>::value>
+	{
+	};
+
+	// The exact shape of a node type, used where two type keys collide.
+	template <class T>
+	struct TypeShape
+	{
+		static constexpr std::uint64_t kind = 0;
+		static constexpr std::uint64_t key = 0;
+		static constexpr std::uint64_t argument = 0;
+		typedef std::tuple<> children;
+	};
+	template <class T>
+	struct TypeShape<Expression<T> > : TypeShape<T>
+	{
+	};
+	template <typename T>
+	struct TypeShape<Numeric<T> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 1;
+		static constexpr std::uint64_t key = std::is_floating_point<T>::value;
+		static constexpr std::uint64_t argument = sizeof(T);
+	};
+	template <typename T, intmax_t N, intmax_t D>
+	struct TypeShape<Constant<T, N, D> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 2;
+		static constexpr std::uint64_t key = (std::uint64_t)N;
+		static constexpr std::uint64_t argument = (std::uint64_t)D;
+	};
+	template <char id>
+	struct TypeShape<Variable<id> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 3;
+		static constexpr std::uint64_t key = (unsigned char)id;
+	};
+	template <class Operator, class Operand>
+	struct TypeShape<UnaryExpression<Operator, Operand> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 4;
+		static constexpr std::uint64_t key = OperatorKey<Operator>::value;
+		typedef std::tuple<Operand> children;
+	};
+	template <class Operator, class Operand>
+	struct TypeShape<PostfixExpression<Operator, Operand> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 5;
+		static constexpr std::uint64_t key = OperatorKey<Operator>::value;
+		typedef std::tuple<Operand> children;
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct TypeShape<BinarryExpression<Operator, LeftOperand, RightOperand> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 6;
+		static constexpr std::uint64_t key = OperatorKey<Operator>::value;
+		typedef std::tuple<LeftOperand, RightOperand> children;
+	};
+	template <class F, class T>
+	struct TypeShape<FunctionExpression<F, T> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 7;
+		static constexpr std::uint64_t key = OperatorKey<F>::value;
+		typedef std::tuple<T> children;
+	};
+	template <class... Ts>
+	struct TypeShape<Sum<Ts...> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 8;
+		typedef std::tuple<Ts...> children;
+	};
+	template <class... Ts>
+	struct TypeShape<Product<Ts...> > : TypeShape<void>
+	{
+		static constexpr std::uint64_t kind = 9;
+		typedef std::tuple<Ts...> children;
+	};
+
+	static constexpr int KeyCompare(std::uint64_t lhs, std::uint64_t rhs)
+	{
+		return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+	}
+
+	template <class T1, class T2>
+	struct TypeCompare;
+
+	template <class L1, class L2>
+	struct TypeListCompare;
+	template <>
+	struct TypeListCompare<std::tuple<>, std::tuple<> >
+	{
+		static constexpr int value = 0;
+	};
+	template <class... Ts>
+	struct TypeListCompare<std::tuple<>, std::tuple<Ts...> >
+	{
+		static constexpr int value = -1;
+	};
+	template <class... Ts>
+	struct TypeListCompare<std::tuple<Ts...>, std::tuple<> >
+	{
+		static constexpr int value = 1;
+	};
+	template <class T1, class... Ts1, class T2, class... Ts2>
+	struct TypeListCompare<std::tuple<T1, Ts1...>, std::tuple<T2, Ts2...> >
+	{
+		static constexpr int value = TypeCompare<T1, T2>::value != 0 ? TypeCompare<T1, T2>::value : TypeListCompare<std::tuple<Ts1...>, std::tuple<Ts2...> >::value;
+	};
+
+	// A total order on node types: the type key first, then the exact shape.
+	// Distinct opaque leaf types have no shape and compare equal.
+	template <class T1, class T2>
+	struct TypeCompare
+	{
+		static constexpr int value =
+			KeyCompare(TypeKey<T1>::value, TypeKey<T2>::value) != 0 ? KeyCompare(TypeKey<T1>::value, TypeKey<T2>::value) :
+			KeyCompare(TypeShape<T1>::kind, TypeShape<T2>::kind) != 0 ? KeyCompare(TypeShape<T1>::kind, TypeShape<T2>::kind) :
+			KeyCompare(TypeShape<T1>::key, TypeShape<T2>::key) != 0 ? KeyCompare(TypeShape<T1>::key, TypeShape<T2>::key) :
+			KeyCompare(TypeShape<T1>::argument, TypeShape<T2>::argument) != 0 ? KeyCompare(TypeShape<T1>::argument, TypeShape<T2>::argument) :
+			TypeListCompare<typename TypeShape<T1>::children, typename TypeShape<T2>::children>::value;
+	};
+	template <class T>
+	struct TypeCompare<T, T>
+	{
+		static constexpr int value = 0;
+	};
+
+	template <class T>
+	struct CanonicalConstant
+	{
+		static constexpr bool value = false;
+	};
+	template <typename T>
+	struct CanonicalConstant<Numeric<T> >
+	{
+		static constexpr bool value = true;
+	};
+
+	template <class... Ts>
+	struct CanonicalOrder
+	{
+		struct Indices
+		{
+			size_t m_index[sizeof...(Ts) + 1];
+			size_t m_count;
+		};
+
+		template <class S>
+		struct Table;
+		template <size_t... k>
+		struct Table<std::index_sequence<k...> >
+		{
+			template <size_t i>
+			using type = typename std::tuple_element<i, std::tuple<Ts...> >::type;
+
+			static constexpr int Get(size_t lhs, size_t rhs)
+			{
+				const int values[] = { TypeCompare<type<k / sizeof...(Ts)>, type<k % sizeof...(Ts)> >::value..., 0 };
+				return values[lhs * sizeof...(Ts) + rhs];
+			}
+		};
+
+		static constexpr Indices Get(bool constants)
+		{
+			Indices result{ {}, 0 };
+			const bool flags[] = { CanonicalConstant<Ts>::value..., false };
+			for (size_t i = 0; i < sizeof...(Ts); ++i)
+			{
+				if (flags[i] != constants) continue;
+				size_t j = result.m_count++;
+				while (j > 0 && Table<std::make_index_sequence<sizeof...(Ts) * sizeof...(Ts)> >::Get(result.m_index[j - 1], i) > 0)
+				{
+					result.m_index[j] = result.m_index[j - 1];
+					--j;
+				}
+				result.m_index[j] = i;
+			}
+			return result;
+		}
+	};
+
+	template <class T>
+	struct StructuralOrder
+	{
+		static inline int Get(const T &, const T &)
+		{
+			return 0;
+		}
+	};
+	template <class T>
+	struct StructuralOrder<Expression<T> > : StructuralOrder<T>
+	{
+	};
+	template <typename T>
+	struct StructuralOrder<Numeric<T> >
+	{
+		static inline int Get(const Numeric<T> & lhs, const Numeric<T> & rhs)
+		{
+			return lhs.m_value < rhs.m_value ? -1 : (rhs.m_value < lhs.m_value ? 1 : 0);
+		}
+	};
+	template <class Operator, class Operand>
+	struct StructuralOrder<UnaryExpression<Operator, Operand> >
+	{
+		static inline int Get(const UnaryExpression<Operator, Operand> & lhs, const UnaryExpression<Operator, Operand> & rhs)
+		{
+			return StructuralOrder<Operand>::Get(lhs.m_operand, rhs.m_operand);
+		}
+	};
+	template <class Operator, class Operand>
+	struct StructuralOrder<PostfixExpression<Operator, Operand> >
+	{
+		static inline int Get(const PostfixExpression<Operator, Operand> & lhs, const PostfixExpression<Operator, Operand> & rhs)
+		{
+			return StructuralOrder<Operand>::Get(lhs.m_operand, rhs.m_operand);
+		}
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct StructuralOrder<BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		static inline int Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & lhs, const BinarryExpression<Operator, LeftOperand, RightOperand> & rhs)
+		{
+			int order = StructuralOrder<LeftOperand>::Get(lhs.m_leftOperand, rhs.m_leftOperand);
+			return order != 0 ? order : StructuralOrder<RightOperand>::Get(lhs.m_rightOperand, rhs.m_rightOperand);
+		}
+	};
+	template <class F, class T>
+	struct StructuralOrder<FunctionExpression<F, T> >
+	{
+		static inline int Get(const FunctionExpression<F, T> & lhs, const FunctionExpression<F, T> & rhs)
+		{
+			return StructuralOrder<T>::Get(lhs.m_operand, rhs.m_operand);
+		}
+	};
+
+	template <class... Ts>
+	struct VariadicOrder
+	{
+		template <size_t... i>
+		static inline int Get(const std::tuple<Ts...> & lhs, const std::tuple<Ts...> & rhs, std::index_sequence<i...>)
+		{
+			int order = 0;
+			std::initializer_list<int>{ (order = order != 0 ? order : StructuralOrder<Ts>::Get(std::get<i>(lhs), std::get<i>(rhs)), 0)... };
+			return order;
+		}
+	};
+	template <class... Ts>
+	struct StructuralOrder<Sum<Ts...> >
+	{
+		static inline int Get(const Sum<Ts...> & lhs, const Sum<Ts...> & rhs)
+		{
+			return VariadicOrder<Ts...>::Get(lhs.m_operands, rhs.m_operands, std::index_sequence_for<Ts...>());
+		}
+	};
+	template <class... Ts>
+	struct StructuralOrder<Product<Ts...> >
+	{
+		static inline int Get(const Product<Ts...> & lhs, const Product<Ts...> & rhs)
+		{
+			return VariadicOrder<Ts...>::Get(lhs.m_operands, rhs.m_operands, std::index_sequence_for<Ts...>());
+		}
+	};
+
+	// Operands of one type are ordered at run time: by structural hash, then
+	// by a full structural comparison.
+	template <bool same>
+	struct CanonicalTie
+	{
+		template <class T1, class T2>
+		static inline void Order(T1 &, T2 &)
+		{
+		}
+	};
+	template <>
+	struct CanonicalTie<true>
+	{
+		template <class T>
+		static inline void Order(T & lhs, T & rhs)
+		{
+			size_t left = Hasher<T>::Get(lhs);
+			size_t right = Hasher<T>::Get(rhs);
+			if (left > right || (left == right && StructuralOrder<T>::Get(lhs, rhs) > 0)) std::swap(lhs, rhs);
+		}
+	};
+
+	template <class... Ts>
+	struct CanonicalTies
+	{
+		template <size_t i>
+		using type = typename std::tuple_element<i, std::tuple<Ts...> >::type;
+
+		template <size_t i>
+		struct Swappable
+		{
+			static constexpr bool value = std::is_same<type<i>, type<i + 1> >::value &&
+				std::is_move_constructible<type<i> >::value &&
+				std::is_move_assignable<type<i> >::value;
+		};
+
+		static inline void Sort(std::tuple<Ts...> & operands)
+		{
+			for (size_t pass = 1; pass < sizeof...(Ts); ++pass) Pass(operands, std::make_index_sequence<sizeof...(Ts) - 1>());
+		}
+
+		template <size_t... i>
+		static inline void Pass(std::tuple<Ts...> & operands, std::index_sequence<i...>)
+		{
+			std::initializer_list<int>{ (CanonicalTie<Swappable<i>::value>::Order(std::get<i>(operands), std::get<i + 1>(operands)), 0)... };
+		}
+	};
+
+	template <class T>
+	struct CanonicalSorter
+	{
+		static inline void Sort(T &)
+		{
+		}
+	};
+	template <class... Ts>
+	struct CanonicalSorter<Sum<Ts...> >
+	{
+		static inline void Sort(Sum<Ts...> & expr)
+		{
+			CanonicalTies<Ts...>::Sort(expr.m_operands);
+		}
+	};
+	template <class... Ts>
+	struct CanonicalSorter<Product<Ts...> >
+	{
+		static inline void Sort(Product<Ts...> & expr)
+		{
+			CanonicalTies<Ts...>::Sort(expr.m_operands);
+		}
+	};
+
+	struct SumReduction
+	{
+		typedef Addition operation;
+		template <class... Ts>
+		using node = Sum<Ts...>;
+	};
+
+	struct ProductReduction
+	{
+		typedef Multiplication operation;
+		template <class... Ts>
+		using node = Product<Ts...>;
+	};
+
+	template <class Reduction, class Tuple, class Constants, class Terms, bool merge = (Constants::size() > 0), size_t count = Terms::size()>
+	struct CanonicalBuilder;
+	template <class Reduction, class... Ts, size_t... c, size_t... i, size_t count>
+	struct CanonicalBuilder<Reduction, std::tuple<Ts...>, std::index_sequence<c...>, std::index_sequence<i...>, false, count>
+	{
+		typedef typename Reduction::template node<typename std::tuple_element<i, std::tuple<Ts...> >::type...> type;
+		static inline type Get(const std::tuple<Ts...> & operands)
+		{
+			return type(std::get<i>(operands)...);
+		}
+	};
+	template <class Reduction, class... Ts, size_t... c, size_t i>
+	struct CanonicalBuilder<Reduction, std::tuple<Ts...>, std::index_sequence<c...>, std::index_sequence<i>, false, 1>
+	{
+		typedef typename std::tuple_element<i, std::tuple<Ts...> >::type type;
+		static inline type Get(const std::tuple<Ts...> & operands)
+		{
+			return std::get<i>(operands);
+		}
+	};
+	template <class Reduction, class... Ts, size_t... c, size_t... i>
+	struct CanonicalBuilder<Reduction, std::tuple<Ts...>, std::index_sequence<c...>, std::index_sequence<i...>, true, 0>
+	{
+		typedef Numeric<typename std::common_type<decltype(std::get<c>(std::declval<const std::tuple<Ts...> &>())())...>::type> type;
+		static inline type Get(const std::tuple<Ts...> & operands)
+		{
+			return{ TreeReduction<typename Reduction::operation, 0, sizeof...(c)>::Get(std::make_tuple(std::get<c>(operands)...), [](const auto & operand)
+			{
+				return operand();
+			}) };
+		}
+	};
+	template <class Reduction, class... Ts, size_t... c, size_t... i, size_t count>
+	struct CanonicalBuilder<Reduction, std::tuple<Ts...>, std::index_sequence<c...>, std::index_sequence<i...>, true, count>
+	{
+		typedef CanonicalBuilder<Reduction, std::tuple<Ts...>, std::index_sequence<c...>, std::index_sequence<>, true, 0> constants;
+		typedef typename Reduction::template node<typename constants::type, typename std::tuple_element<i, std::tuple<Ts...> >::type...> type;
+		static inline type Get(const std::tuple<Ts...> & operands)
+		{
+			return type(constants::Get(operands), std::get<i>(operands)...);
+		}
+	};
+
+	template <class Reduction, class Tuple, class C, class I>
+	struct CanonicalIndices;
+	template <class Reduction, class... Ts, size_t... c, size_t... i>
+	struct CanonicalIndices<Reduction, std::tuple<Ts...>, std::index_sequence<c...>, std::index_sequence<i...> >
+		: CanonicalBuilder<
+			Reduction,
+			std::tuple<Ts...>,
+			std::index_sequence<CanonicalOrder<Ts...>::Get(true).m_index[c]...>,
+			std::index_sequence<CanonicalOrder<Ts...>::Get(false).m_index[i]...>
+		>
+	{
+	};
+
+	template <class Reduction, class... Ts>
+	static inline auto combine(const std::tuple<Ts...> & operands)
+	{
+		auto result = CanonicalIndices<
+			Reduction,
+			std::tuple<Ts...>,
+			std::make_index_sequence<CanonicalOrder<Ts...>::Get(true).m_count>,
+			std::make_index_sequence<CanonicalOrder<Ts...>::Get(false).m_count>
+		>::Get(operands);
+		CanonicalSorter<decltype(result)>::Sort(result);
+		return result;
+	}
+
+	template <class T>
+	struct Canonicalizer;
+
+	template <class Operator, class T>
+	struct Flattener
+	{
+		static inline auto Get(const T & expr)
+		{
+			return std::make_tuple(Canonicalizer<T>::Get(expr));
+		}
+	};
+	template <class Operator, class T>
+	struct Flattener<Operator, Expression<T> > : Flattener<Operator, T>
+	{
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct Flattener<Operator, BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		static inline auto Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
+		{
+			return std::tuple_cat(Flattener<Operator, LeftOperand>::Get(expr.m_leftOperand), Flattener<Operator, RightOperand>::Get(expr.m_rightOperand));
+		}
+	};
+	template <class... Ts>
+	struct Flattener<Addition, Sum<Ts...> >
+	{
+		static inline auto Get(const Sum<Ts...> & expr)
+		{
+			return Flatten(expr.m_operands, std::index_sequence_for<Ts...>());
+		}
+
+		template <size_t... i>
+		static inline auto Flatten(const std::tuple<Ts...> & operands, std::index_sequence<i...>)
+		{
+			return std::tuple_cat(Flattener<Addition, Ts>::Get(std::get<i>(operands))...);
+		}
+	};
+	template <class... Ts>
+	struct Flattener<Multiplication, Product<Ts...> >
+	{
+		static inline auto Get(const Product<Ts...> & expr)
+		{
+			return Flatten(expr.m_operands, std::index_sequence_for<Ts...>());
+		}
+
+		template <size_t... i>
+		static inline auto Flatten(const std::tuple<Ts...> & operands, std::index_sequence<i...>)
+		{
+			return std::tuple_cat(Flattener<Multiplication, Ts>::Get(std::get<i>(operands))...);
+		}
+	};
+
+	template <class T>
+	struct Canonicalizer
+	{
+		static inline T Get(const T & expr)
+		{
+			return expr;
+		}
+	};
+	template <class T>
+	struct Canonicalizer<Expression<T> > : Canonicalizer<T>
+	{
+	};
+	template <class Operator, class Operand>
+	struct Canonicalizer<UnaryExpression<Operator, Operand> >
+	{
+		static inline auto Get(const UnaryExpression<Operator, Operand> & expr)
+		{
+			auto operand = Canonicalizer<Operand>::Get(expr.m_operand);
+			return UnaryExpression<Operator, decltype(operand)>(std::move(operand));
+		}
+	};
+	template <class Operator, class Operand>
+	struct Canonicalizer<PostfixExpression<Operator, Operand> >
+	{
+		static inline auto Get(const PostfixExpression<Operator, Operand> & expr)
+		{
+			auto operand = Canonicalizer<Operand>::Get(expr.m_operand);
+			return PostfixExpression<Operator, decltype(operand)>(std::move(operand));
+		}
+	};
+	template <class F, class T>
+	struct Canonicalizer<FunctionExpression<F, T> >
+	{
+		static inline auto Get(const FunctionExpression<F, T> & expr)
+		{
+			auto operand = Canonicalizer<T>::Get(expr.m_operand);
+			return FunctionExpression<F, decltype(operand)>(std::move(operand));
+		}
+	};
+	template <class Operator, class LeftOperand, class RightOperand>
+	struct Canonicalizer<BinarryExpression<Operator, LeftOperand, RightOperand> >
+	{
+		static inline auto Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
+		{
+			auto lhs = Canonicalizer<LeftOperand>::Get(expr.m_leftOperand);
+			auto rhs = Canonicalizer<RightOperand>::Get(expr.m_rightOperand);
+			return BinarryExpression<Operator, decltype(lhs), decltype(rhs)>(std::move(lhs), std::move(rhs));
+		}
+	};
+	template <class LeftOperand, class RightOperand>
+	struct Canonicalizer<BinarryExpression<Addition, LeftOperand, RightOperand> >
+	{
+		static inline auto Get(const BinarryExpression<Addition, LeftOperand, RightOperand> & expr)
+		{
+			return combine<SumReduction>(Flattener<Addition, BinarryExpression<Addition, LeftOperand, RightOperand> >::Get(expr));
+		}
+	};
+	template <class LeftOperand, class RightOperand>
+	struct Canonicalizer<BinarryExpression<Multiplication, LeftOperand, RightOperand> >
+	{
+		static inline auto Get(const BinarryExpression<Multiplication, LeftOperand, RightOperand> & expr)
+		{
+			return combine<ProductReduction>(Flattener<Multiplication, BinarryExpression<Multiplication, LeftOperand, RightOperand> >::Get(expr));
+		}
+	};
+	template <class... Ts>
+	struct Canonicalizer<Sum<Ts...> >
+	{
+		static inline auto Get(const Sum<Ts...> & expr)
+		{
+			return combine<SumReduction>(Flattener<Addition, Sum<Ts...> >::Get(expr));
+		}
+	};
+	template <class... Ts>
+	struct Canonicalizer<Product<Ts...> >
+	{
+		static inline auto Get(const Product<Ts...> & expr)
+		{
+			return combine<ProductReduction>(Flattener<Multiplication, Product<Ts...> >::Get(expr));
+		}
+	};
+
+	template <class T>
+	static inline auto canonicalize(const Expression<T> & expr)
+	{
+		return Canonicalizer<T>::Get(expr());
+	}
+	template <char id, size_t degree, typename V>
+	struct Polynomial : Expression<Polynomial<id, degree, V> >
+	{
+		typedef std::array<V, degree + 1> coefficients;
+
+		Polynomial(coefficients coefficients)
+			: m_coefficients(std::move(coefficients))
+		{
+		}
+
+		Polynomial<id, degree, V> operator()() const
+		{
+			return *this;
+		}
+
+		template <typename T>
+		T Get(T value) const
+		{
+			T result = (T)m_coefficients[degree];
+			for (size_t k = degree; k-- > 0;)
+			{
+				result = result * value + (T)m_coefficients[k];
+			}
+			return result;
+		}
+
+		operator std::string() const
+		{
+			return print(*this);
+		}
+
+		coefficients m_coefficients;
+	};
+
+	static constexpr int PolynomialMax(int lhs, int rhs)
 	{
-		return Expander<terms, T>::Expand(exp);
+		return lhs < 0 || rhs < 0 ? -1 : (lhs > rhs ? lhs : rhs);
 	}
 
-	template <class T, typename T1, typename T2>
-	static inline typename Binder<T, T1, typename ExpressionOperator<T2>::type>::type bind(const Expression<T> & expr, const T1& var, const T2& value)
+	static constexpr int PolynomialSum(int lhs, int rhs)
 	{
-		return Binder<T, T1, typename ExpressionOperator<T2>::type>::Bind(expr(), var, ExpressionOperator<T2>::GetParam(value));
+		return lhs < 0 || rhs < 0 ? -1 : lhs + rhs;
 	}
 
-	template <class T>
-	static inline auto derive(const Expression<T> & exp)
+	static constexpr int PolynomialFold(std::initializer_list<int> degrees, bool product)
 	{
-		return Derivation<T>::Derive(exp());
+		int result = 0;
+		for (int degree : degrees)
+		{
+			result = product ? PolynomialSum(result, degree) : PolynomialMax(result, degree);
+		}
+		return result;
 	}
 
-	template <class T>
-	struct Derivation<Expression<T>>
+	template <char id, class T>
+	struct PolynomialDegree
 	{
-		typedef typename Derivation<T>::type type;
-		static inline type Derive(const T& exp)
+		static constexpr int value = -1;
+	};
+	template <char id, class T>
+	struct PolynomialDegree<id, Expression<T> > : PolynomialDegree<id, T>
+	{
+	};
+	template <char id, typename T>
+	struct PolynomialDegree<id, Numeric<T> >
+	{
+		static constexpr int value = std::is_arithmetic<T>::value ? 0 : -1;
+	};
+	template <char id, typename T, intmax_t N, intmax_t D>
+	struct PolynomialDegree<id, Constant<T, N, D> >
+	{
+		static constexpr int value = 0;
+	};
+	template <char id>
+	struct PolynomialDegree<id, Variable<id> >
+	{
+		static constexpr int value = 1;
+	};
+	template <char id, size_t degree, typename V>
+	struct PolynomialDegree<id, Polynomial<id, degree, V> >
+	{
+		static constexpr int value = (int)degree;
+	};
+	template <char id, class T>
+	struct PolynomialDegree<id, UnaryExpression<UnaryMinus, T> > : PolynomialDegree<id, T>
+	{
+	};
+	template <char id, class T>
+	struct PolynomialDegree<id, UnaryExpression<UnaryAddition, T> > : PolynomialDegree<id, T>
+	{
+	};
+	template <char id, class T>
+	struct PolynomialDegree<id, UnaryExpression<UnarySubtraction, T> > : PolynomialDegree<id, T>
+	{
+	};
+	template <char id, class T1, class T2>
+	struct PolynomialDegree<id, BinarryExpression<Addition, T1, T2> >
+	{
+		static constexpr int value = PolynomialMax(PolynomialDegree<id, T1>::value, PolynomialDegree<id, T2>::value);
+	};
+	template <char id, class T1, class T2>
+	struct PolynomialDegree<id, BinarryExpression<Subtraction, T1, T2> >
+	{
+		static constexpr int value = PolynomialMax(PolynomialDegree<id, T1>::value, PolynomialDegree<id, T2>::value);
+	};
+	template <char id, class T1, class T2>
+	struct PolynomialDegree<id, BinarryExpression<Multiplication, T1, T2> >
+	{
+		static constexpr int value = PolynomialSum(PolynomialDegree<id, T1>::value, PolynomialDegree<id, T2>::value);
+	};
+	template <char id, class T1, class T2>
+	struct PolynomialDegree<id, BinarryExpression<Division, T1, T2> >
+	{
+		static constexpr int value = PolynomialDegree<id, T2>::value == 0 ? PolynomialDegree<id, T1>::value : -1;
+	};
+	template <char id, int p, class T>
+	struct PolynomialDegree<id, PostfixExpression<Power<p>, T> >
+	{
+		static constexpr int value = p < 0 || PolynomialDegree<id, T>::value < 0 ? -1 : p * PolynomialDegree<id, T>::value;
+	};
+	template <char id, class... Ts>
+	struct PolynomialDegree<id, Sum<Ts...> >
+	{
+		static constexpr int value = PolynomialFold({ PolynomialDegree<id, Ts>::value... }, false);
+	};
+	template <char id, class... Ts>
+	struct PolynomialDegree<id, Product<Ts...> >
+	{
+		static constexpr int value = PolynomialFold({ PolynomialDegree<id, Ts>::value... }, true);
+	};
+
+	struct PolynomialArithmetic
+	{
+		template <typename V, size_t n, size_t m>
+		static inline std::array<V, (n > m ? n : m)> Add(const std::array<V, n> & lhs, const std::array<V, m> & rhs, V sign)
 		{
-			return Derivation<T>::Derive(exp);
+			std::array<V, (n > m ? n : m)> result{};
+			for (size_t k = 0; k < n; ++k) result[k] = lhs[k];
+			for (size_t k = 0; k < m; ++k) result[k] += sign * rhs[k];
+			return result;
+		}
+
+		template <typename V, size_t n, size_t m>
+		static inline std::array<V, n + m - 1> Multiply(const std::array<V, n> & lhs, const std::array<V, m> & rhs)
+		{
+			std::array<V, n + m - 1> result{};
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t j = 0; j < m; ++j) result[i + j] += lhs[i] * rhs[j];
+			}
+			return result;
+		}
+
+		template <typename V, size_t n>
+		static inline std::array<V, n> Scale(std::array<V, n> coefficients, V factor)
+		{
+			for (auto & coefficient : coefficients) coefficient *= factor;
+			return coefficients;
+		}
+
+		template <typename V, size_t n, size_t m>
+		static inline auto Apply(Addition, const std::array<V, n> & lhs, const std::array<V, m> & rhs)
+		{
+			return Add(lhs, rhs, (V)1);
+		}
+
+		template <typename V, size_t n, size_t m>
+		static inline auto Apply(Multiplication, const std::array<V, n> & lhs, const std::array<V, m> & rhs)
+		{
+			return Multiply(lhs, rhs);
 		}
 	};
 
-	template <class T1, class T2>
-	struct Derivation<BinarryExpression<Addition, T1, T2>>
+	template <int p, bool odd = p % 2 == 1>
+	struct PolynomialPower
 	{
-		typedef BinarryExpression<Addition, typename Derivation<T1>::type, typename Derivation<T2>::type> type;
-		static inline type Derive(const BinarryExpression<Addition, T1, T2> & exp)
+		template <typename V, size_t n>
+		static inline auto Get(const std::array<V, n> & coefficients)
 		{
-			return{ Derivation<T1>::Derive(exp.m_leftOperand), Derivation<T2>::Derive(exp.m_rightOperand) };
+			auto half = PolynomialPower<p / 2>::Get(coefficients);
+			return PolynomialArithmetic::Multiply(half, half);
 		}
 	};
-
-	template <class T1, class T2>
-	struct Derivation<BinarryExpression<Subtraction, T1, T2>>
+	template <int p>
+	struct PolynomialPower<p, true>
 	{
-		typedef BinarryExpression<Subtraction, typename Derivation<T1>::type, typename Derivation<T2>::type> type;
-		static inline type Derive(const BinarryExpression<Subtraction, T1, T2> & exp)
+		template <typename V, size_t n>
+		static inline auto Get(const std::array<V, n> & coefficients)
 		{
-			return{ Derivation<T1>::Derive(exp.m_leftOperand), Derivation<T2>::Derive(exp.m_rightOperand) };
+			return PolynomialArithmetic::Multiply(PolynomialPower<p - 1>::Get(coefficients), coefficients);
 		}
 	};
-
-	template <class T1, class T2>
-	struct Derivation<BinarryExpression<Multiplication, T1, T2>>
+	template <>
+	struct PolynomialPower<0, false>
 	{
-		typedef
-			BinarryExpression<
-				Addition,
-				BinarryExpression<
-					Multiplication,
-					typename Derivation<T1>::type,
-					T2
-				>,
-				BinarryExpression<
-					Multiplication,
-					T1,
-					typename Derivation<T2>::type
-				>
-			> type;
-		static inline type Derive(const BinarryExpression<Multiplication, T1, T2> & exp)
+		template <typename V, size_t n>
+		static inline std::array<V, 1> Get(const std::array<V, n> &)
 		{
-			return
-			{
-				{ Derivation<T1>::Derive(exp.m_leftOperand), exp.m_rightOperand },
-				{ exp.m_leftOperand, Derivation<T2>::Derive(exp.m_rightOperand) }
-			};
+			return{ { (V)1 } };
 		}
 	};
 
-	template <class T1, class T2>
-	struct Derivation<BinarryExpression<Division, T1, T2>>
+	template <char id, typename V, class T>
+	struct PolynomialCoefficients<id, V, Expression<T> > : PolynomialCoefficients<id, V, T>
 	{
-		typedef
-			BinarryExpression<
-				Division,
-				BinarryExpression<
-					Subtraction,
-					BinarryExpression<
-						Multiplication,
-						typename Derivation<T1>::type,
-						T2
-					>,
-					BinarryExpression<
-						Multiplication,
-						T1,
-						typename Derivation<T2>::type
-					>
-				>,
-				PostfixExpression<Power<2>, T2>
-			> type;
-		static inline type Derive(const BinarryExpression<Division, T1, T2> & exp)
+	};
+	template <char id, typename V, typename T>
+	struct PolynomialCoefficients<id, V, Numeric<T> >
+	{
+		static inline std::array<V, 1> Get(const Numeric<T> & expr)
 		{
-			return
-			{
-				{
-					{ Derivation<T1>::Derive(exp.m_leftOperand), exp.m_rightOperand },
-					{ exp.m_leftOperand, Derivation<T2>::Derive(exp.m_rightOperand) }
-				},
-				power<2>(exp.m_rightOperand)
-			};
+			return{ { (V)expr.m_value } };
 		}
 	};
-
-	template <class Operator, class Operand>
-	struct Derivation<UnaryExpression<Operator, Operand> >
+	template <char id, typename V, typename T, intmax_t N, intmax_t D>
+	struct PolynomialCoefficients<id, V, Constant<T, N, D> >
 	{
-		typedef
-			UnaryExpression<
-			Operator,
-			typename Derivation<Operand>::type
-			> type;
-		static inline type Derive(const UnaryExpression<Operator, Operand> & exp)
+		static inline std::array<V, 1> Get(const Constant<T, N, D> & expr)
 		{
-			return{ Derivation<Operand>::Derive(exp.m_operand) };
+			return{ { (V)expr() } };
 		}
 	};
-
-	template <typename T>
-	struct Derivation<Numeric<T>>
+	template <char id, typename V>
+	struct PolynomialCoefficients<id, V, Variable<id> >
 	{
-		typedef Numeric<int> type;
-		static inline type Derive(const Numeric<T> &)
+		static inline std::array<V, 2> Get(const Variable<id> &)
 		{
-			return{ 0 };
+			return{ { (V)0, (V)1 } };
 		}
 	};
-
-	template <typename T, intmax_t N, intmax_t D>
-	struct Derivation<Constant<T, N, D>>
+	template <char id, typename V, size_t degree, typename T>
+	struct PolynomialCoefficients<id, V, Polynomial<id, degree, T> >
 	{
-		typedef Numeric<int> type;
-		static inline type Derive(const Constant<T, N, D> &)
+		static inline std::array<V, degree + 1> Get(const Polynomial<id, degree, T> & expr)
 		{
-			return{ 0 };
+			std::array<V, degree + 1> result;
+			for (size_t k = 0; k <= degree; ++k) result[k] = (V)expr.m_coefficients[k];
+			return result;
 		}
 	};
-
-	template <typename T>
-	struct Derivation<FunctionExpression<Sinus, T>>
+	template <char id, typename V, class T>
+	struct PolynomialCoefficients<id, V, UnaryExpression<UnaryMinus, T> >
 	{
-		typedef BinarryExpression<Multiplication, FunctionExpression<Cosinus, T>, typename Derivation<T>::type> type;
-		static inline type Derive(const FunctionExpression<Sinus, T> & exp)
+		static inline auto Get(const UnaryExpression<UnaryMinus, T> & expr)
 		{
-			return
-			{
-				cos(exp.m_operand),
-				Derivation<T>::Derive(exp.m_operand)
-			};
+			return PolynomialArithmetic::Scale(PolynomialCoefficients<id, V, T>::Get(expr.m_operand), (V)-1);
 		}
 	};
-
-	template <typename T>
-	struct Derivation<FunctionExpression<Cosinus, T>>
+	template <char id, typename V, class T>
+	struct PolynomialCoefficients<id, V, UnaryExpression<UnaryAddition, T> >
 	{
-		typedef BinarryExpression<Multiplication, UnaryExpression<UnaryMinus, FunctionExpression<Sinus, T> >, typename Derivation<T>::type> type;
-		static inline type Derive(const FunctionExpression<Cosinus, T> & exp)
+		static inline auto Get(const UnaryExpression<UnaryAddition, T> & expr)
 		{
-			return
-			{
-				-sin(exp.m_operand),
-				Derivation<T>::Derive(exp.m_operand)
-			};
+			auto result = PolynomialCoefficients<id, V, T>::Get(expr.m_operand);
+			result[0] += 1;
+			return result;
 		}
 	};
-
-	template <int p, typename T>
-	struct Derivation<PostfixExpression<Power<p>, T>>
+	template <char id, typename V, class T>
+	struct PolynomialCoefficients<id, V, UnaryExpression<UnarySubtraction, T> >
 	{
-		typedef
-			BinarryExpression<
-				Multiplication,
-				BinarryExpression<
-					Multiplication,
-					Numeric<int>,
-					PostfixExpression<
-						Power<p - 1>,
-						T
-					>
-				>,
-				typename Derivation<T>::type
-			> type;
-		static inline type Derive(const PostfixExpression<Power<p>, T> & exp)
+		static inline auto Get(const UnaryExpression<UnarySubtraction, T> & expr)
 		{
-			return
-			{
-				{ p, power<p - 1>(exp.m_operand) },
-				{ Derivation<T>::Derive(exp.m_operand) }
-			};
+			auto result = PolynomialCoefficients<id, V, T>::Get(expr.m_operand);
+			result[0] -= 1;
+			return result;
 		}
 	};
-
-	template <char id>
-	struct Derivation<Variable<id>>
+	template <char id, typename V, class T1, class T2>
+	struct PolynomialCoefficients<id, V, BinarryExpression<Addition, T1, T2> >
 	{
-		typedef Numeric<int> type;
-		static inline type Derive(const Variable<id> &)
+		static inline auto Get(const BinarryExpression<Addition, T1, T2> & expr)
 		{
-			return{ 1 };
+			return PolynomialArithmetic::Add(PolynomialCoefficients<id, V, T1>::Get(expr.m_leftOperand), PolynomialCoefficients<id, V, T2>::Get(expr.m_rightOperand), (V)1);
 		}
 	};
-
-	template <class T>
-	struct Lopital
+	template <char id, typename V, class T1, class T2>
+	struct PolynomialCoefficients<id, V, BinarryExpression<Subtraction, T1, T2> >
 	{
-		typedef T type;
-		static inline type Get(const T & expr)
+		static inline auto Get(const BinarryExpression<Subtraction, T1, T2> & expr)
 		{
-			return expr;
+			return PolynomialArithmetic::Add(PolynomialCoefficients<id, V, T1>::Get(expr.m_leftOperand), PolynomialCoefficients<id, V, T2>::Get(expr.m_rightOperand), (V)-1);
 		}
 	};
-
-	template <class T>
-	struct Lopital<Expression<T>>
+	template <char id, typename V, class T1, class T2>
+	struct PolynomialCoefficients<id, V, BinarryExpression<Multiplication, T1, T2> >
 	{
-		typedef typename Lopital<T>::type type;
-		static inline type Get(const Expression<T> & expr)
+		static inline auto Get(const BinarryExpression<Multiplication, T1, T2> & expr)
 		{
-			return Lopital<T>::Get(expr());
+			return PolynomialArithmetic::Multiply(PolynomialCoefficients<id, V, T1>::Get(expr.m_leftOperand), PolynomialCoefficients<id, V, T2>::Get(expr.m_rightOperand));
 		}
 	};
-
-	template <class T1, class T2>
-	struct Lopital<BinarryExpression<Division, T1, T2> >
+	template <char id, typename V, class T1, class T2>
+	struct PolynomialCoefficients<id, V, BinarryExpression<Division, T1, T2> >
 	{
-		typedef BinarryExpression<
-			Division,
-			typename Derivation<T1>::type,
-			typename Derivation<T2>::type
-		> type;
-		static inline type Get(const BinarryExpression<Division, T1, T2> & expr)
+		static inline auto Get(const BinarryExpression<Division, T1, T2> & expr)
 		{
-			return{ derive(expr.m_leftOperand), derive(expr.m_rightOperand) };
+			return PolynomialArithmetic::Scale(PolynomialCoefficients<id, V, T1>::Get(expr.m_leftOperand), (V)1 / PolynomialCoefficients<id, V, T2>::Get(expr.m_rightOperand)[0]);
 		}
 	};
-
-	template <class T>
-	static inline auto lopital(const T& expr)
+	template <char id, typename V, int p, class T>
+	struct PolynomialCoefficients<id, V, PostfixExpression<Power<p>, T> >
 	{
-		return Lopital<T>::Get(expr);
-	}
+		static inline auto Get(const PostfixExpression<Power<p>, T> & expr)
+		{
+			return PolynomialPower<p>::Get(PolynomialCoefficients<id, V, T>::Get(expr.m_operand));
+		}
+	};
 
-	template <typename T>
-	struct HasDivision;
-	template <char id>
-	struct HasDivision<Variable<id>>
+	template <char id, typename V, class Operator, size_t i, bool last, class... Ts>
+	struct VariadicCoefficients
 	{
-		static constexpr bool value = false;
+		static inline auto Get(const std::tuple<Ts...> & operands)
+		{
+			typedef typename std::tuple_element<i, std::tuple<Ts...> >::type type;
+			return PolynomialArithmetic::Apply(
+				Operator(),
+				PolynomialCoefficients<id, V, type>::Get(std::get<i>(operands)),
+				VariadicCoefficients<id, V, Operator, i + 1, i + 2 == sizeof...(Ts), Ts...>::Get(operands)
+			);
+		}
 	};
-	template <typename T>
-	struct HasDivision<Numeric<T>>
+	template <char id, typename V, class Operator, size_t i, class... Ts>
+	struct VariadicCoefficients<id, V, Operator, i, true, Ts...>
+	{
+		static inline auto Get(const std::tuple<Ts...> & operands)
+		{
+			typedef typename std::tuple_element<i, std::tuple<Ts...> >::type type;
+			return PolynomialCoefficients<id, V, type>::Get(std::get<i>(operands));
+		}
+	};
+
+	template <char id, typename V, class... Ts>
+	struct PolynomialCoefficients<id, V, Sum<Ts...> >
 	{
-		static constexpr bool value = false;
+		static inline auto Get(const Sum<Ts...> & expr)
+		{
+			return VariadicCoefficients<id, V, Addition, 0, sizeof...(Ts) == 1, Ts...>::Get(expr.m_operands);
+		}
 	};
-	template <typename T, intmax_t N, intmax_t D>
-	struct HasDivision<Constant<T, N, D>>
+	template <char id, typename V, class... Ts>
+	struct PolynomialCoefficients<id, V, Product<Ts...> >
 	{
-		static constexpr bool value = false;
+		static inline auto Get(const Product<Ts...> & expr)
+		{
+			return VariadicCoefficients<id, V, Multiplication, 0, sizeof...(Ts) == 1, Ts...>::Get(expr.m_operands);
+		}
 	};
-	template <class Operator, class LeftOperand, class RightOperand>
-	struct HasDivision<BinarryExpression<Operator, LeftOperand, RightOperand>>
+
+	template <size_t k, size_t degree>
+	struct HornerExpansion
 	{
-		static constexpr bool value = HasDivision<LeftOperand>::value || HasDivision<RightOperand>::value;
+		template <typename V, class T>
+		static inline auto Get(const std::array<V, degree + 1> & coefficients, const T & value)
+		{
+			auto tail = HornerExpansion<k + 1, degree>::Get(coefficients, value);
+			return BinarryExpression<Addition, Numeric<V>, BinarryExpression<Multiplication, T, decltype(tail)> >(
+				Numeric<V>{ coefficients[k] },
+				BinarryExpression<Multiplication, T, decltype(tail)>(value, std::move(tail))
+			);
+		}
 	};
-	template <class LeftOperand, class RightOperand>
-	struct HasDivision<BinarryExpression<Division, LeftOperand, RightOperand>>
+	template <size_t degree>
+	struct HornerExpansion<degree, degree>
 	{
-		static constexpr bool value = true;
+		template <typename V, class T>
+		static inline Numeric<V> Get(const std::array<V, degree + 1> & coefficients, const T &)
+		{
+			return{ coefficients[degree] };
+		}
 	};
-	template <class Operator, class Operand>
-	struct HasDivision<UnaryExpression<Operator, Operand>>
+
+	template <char id, size_t degree, typename V>
+	struct HasVariables<Polynomial<id, degree, V> >
 	{
-		static constexpr bool value = HasDivision<Operand>::value;
+		static constexpr bool value = true;
 	};
-	template <class F, class T>
-	struct HasDivision<FunctionExpression<F, T>>
+	template <char id, size_t degree, typename V>
+	struct Variables<Polynomial<id, degree, V> >
 	{
-		static constexpr bool value = HasDivision<T>::value;
+		typedef VariableList<id> type;
 	};
-	template <class Operator, class Operand>
-	struct HasDivision<PostfixExpression<Operator, Operand>>
+	template <char id, size_t degree, typename V>
+	struct HasDivision<Polynomial<id, degree, V> >
 	{
-		static constexpr bool value = HasDivision<Operand>::value;
+		static constexpr bool value = false;
 	};
-	template <class T>
-	struct HasDivision<Expression<T>>
+	template <char id, size_t degree, typename V>
+	struct StagerBase<Polynomial<id, degree, V>, true>
 	{
-		static constexpr bool value = HasDivision<T>::value;
+		typedef Polynomial<id, degree, V> type;
+		static inline type Stage(const Polynomial<id, degree, V> & expr)
+		{
+			return expr;
+		}
 	};
 
-	template <class T1, class T2, bool first, bool second>
-	struct DivisionSegregator;
-	template <class T1, class T2>
-	struct DivisionSegregator<T1, T2, true, false>
+	template <char id, size_t degree, typename V>
+	struct Evaluator<Polynomial<id, degree, V> >
 	{
-		typedef T1 type;
-		static inline type Get(const T1 & t1, const T2 &)
+		template <class E>
+		static inline auto Get(const Polynomial<id, degree, V> & expr, const E & env)
 		{
-			return t1;
+			return expr.Get((typename E::value_type)env.template Get<id>());
 		}
 	};
-	template <class T1, class T2>
-	struct DivisionSegregator<T1, T2, false, true>
+
+	template <char id, size_t degree, typename V, class T, bool variables = HasVariables<T>::value>
+	struct PolynomialBinder
 	{
-		typedef T2 type;
-		static inline type Get(const T1 &, const T2 & t2)
+		typedef decltype(HornerExpansion<0, degree>::Get(std::declval<const std::array<V, degree + 1> &>(), std::declval<const T &>())) type;
+		static inline type Bind(const Polynomial<id, degree, V> & exp, const T & value)
 		{
-			return t2;
+			return HornerExpansion<0, degree>::Get(exp.m_coefficients, value);
 		}
 	};
-	template <class T1, class T2>
-	struct DivisionSegregator<T1, T2, true, true>
+	template <char id, size_t degree, typename V, class T>
+	struct PolynomialBinder<id, degree, V, T, false>
 	{
-		typedef T1 type;
-		static inline type Get(const T1 & t1, const T2 &)
+		typedef Numeric<V> type;
+		static inline type Bind(const Polynomial<id, degree, V> & exp, const T & value)
 		{
-			return t1;
+			return{ exp.Get((V)value()) };
 		}
 	};
 
-	template <typename T>
-	struct FirstDivision;
-	template <class Operator, class LeftOperand, class RightOperand>
-	struct FirstDivision<BinarryExpression<Operator, LeftOperand, RightOperand>>
+	template <char id, size_t degree, typename V, typename T>
+	struct Binder<Polynomial<id, degree, V>, Variable<id>, T> : PolynomialBinder<id, degree, V, T>
 	{
-		static constexpr bool value = false;
-		typedef typename FirstDivision<
-			typename DivisionSegregator<
-				LeftOperand,
-				RightOperand,
-				HasDivision<LeftOperand>::value,
-				HasDivision<RightOperand>::value
-			>::type
-		>::type type;
-		static inline type Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
+		static inline typename PolynomialBinder<id, degree, V, T>::type Bind(const Polynomial<id, degree, V> & exp, const Variable<id> &, const T & value)
 		{
-			return FirstDivision<
-				typename DivisionSegregator<
-					LeftOperand,
-					RightOperand,
-					HasDivision<LeftOperand>::value,
-					HasDivision<RightOperand>::value
-				>::type
-			>::Get(
-				DivisionSegregator<
-					LeftOperand,
-					RightOperand,
-					HasDivision<LeftOperand>::value,
-					HasDivision<RightOperand>::value
-				>::Get(expr.m_leftOperand, expr.m_rightOperand)
-				);
+			return PolynomialBinder<id, degree, V, T>::Bind(exp, value);
 		}
 	};
-	template <class LeftOperand, class RightOperand>
-	struct FirstDivision<BinarryExpression<Division, LeftOperand, RightOperand>>
+	template <char id1, size_t degree, typename V, char id2, typename T>
+	struct Binder<Polynomial<id1, degree, V>, Variable<id2>, T>
 	{
-		static constexpr bool value = true;
-		typedef BinarryExpression<Division, LeftOperand, RightOperand> type;
-		static inline type Get(const BinarryExpression<Division, LeftOperand, RightOperand> & expr)
+		typedef Polynomial<id1, degree, V> type;
+		static inline type Bind(const Polynomial<id1, degree, V> & exp, const Variable<id2> &, const T &)
 		{
-			return{ expr.m_leftOperand, expr.m_rightOperand };
+			return exp;
 		}
 	};
-	template <class F, class T>
-	struct FirstDivision<UnaryExpression<F, T>>
+
+	template <char id, size_t degree, typename V>
+	struct Derivation<Polynomial<id, degree, V> >
 	{
-		static constexpr bool value = false;
-		typedef typename FirstDivision<T>::type type;
-		static inline type Get(const UnaryExpression<F, T> & expr)
+		typedef Polynomial<id, (degree > 0 ? degree - 1 : 0), V> type;
+		static inline type Derive(const Polynomial<id, degree, V> & exp)
 		{
-			return FirstDivision<T>::Get(expr.m_operand);
+			typename type::coefficients coefficients{};
+			for (size_t k = 1; k <= degree; ++k) coefficients[k - 1] = (V)k * exp.m_coefficients[k];
+			return{ coefficients };
 		}
 	};
-	template <class F, class T>
-	struct FirstDivision<FunctionExpression<F, T>>
+
+	template <char id, size_t degree, typename V>
+	struct Hasher<Polynomial<id, degree, V> >
 	{
-		static constexpr bool value = true;
-		typedef typename FirstDivision<T>::type type;
-		static inline type Get(const FunctionExpression<F, T> & expr)
+		static inline size_t Get(const Polynomial<id, degree, V> & expr)
 		{
-			return FirstDivision<T>::Get(expr.m_operand);
+			size_t seed = HashCombine((size_t)HashTag::Polynomial, (size_t)(unsigned char)id);
+			for (const auto & coefficient : expr.m_coefficients) seed = HashCombine(seed, std::hash<V>()(coefficient));
+			return seed;
 		}
 	};
-	template <class F, class T>
-	struct FirstDivision<PostfixExpression<F, T>>
+	template <char id, size_t degree, typename V>
+	struct Equality<Polynomial<id, degree, V>, Polynomial<id, degree, V> >
 	{
-		static constexpr bool value = true;
-		typedef typename FirstDivision<T>::type type;
-		static inline type Get(const PostfixExpression<F, T> & expr)
+		static inline bool Get(const Polynomial<id, degree, V> & lhs, const Polynomial<id, degree, V> & rhs)
 		{
-			return FirstDivision<T>::Get(expr.m_operand);
+			return lhs.m_coefficients == rhs.m_coefficients;
 		}
 	};
-	template <class T>
-	struct FirstDivision<Expression<T>>
+	template <char id, size_t degree, typename V>
+	struct StructuralOrder<Polynomial<id, degree, V> >
 	{
-		static constexpr bool value = FirstDivision<T>::value;
-		typedef typename FirstDivision<T>::type type;
-		static inline type Get(const Expression<T> & expr)
+		static inline int Get(const Polynomial<id, degree, V> & lhs, const Polynomial<id, degree, V> & rhs)
 		{
-			return FirstDivision<T>::Get(expr());
+			return lhs.m_coefficients < rhs.m_coefficients ? -1 : (rhs.m_coefficients < lhs.m_coefficients ? 1 : 0);
 		}
 	};
-
-	template <typename T1, typename T>
-	struct SimplifierBase;
-	template <class O, class L1, class R1, class L2, class R2>
-	struct SimplifierBase<BinarryExpression<O, L1, R1>, BinarryExpression<Division, L2, R2>>
+	template <char id, size_t degree, typename V>
+	struct TypeShape<Polynomial<id, degree, V> > : TypeShape<void>
 	{
-		typedef BinarryExpression<
-			Division,
-			BinarryExpression<
-				O,
-				BinarryExpression<
-					Multiplication,
-					L1,
-					R2
-				>,
-				BinarryExpression<
-					Multiplication,
-					R1,
-					R2
-				>
-			>,
-			R2
-		> type;
+		static constexpr std::uint64_t kind = 10;
+		static constexpr std::uint64_t key = (unsigned char)id;
+		static constexpr std::uint64_t argument = degree;
+	};
 
-		static inline type Simplify(const BinarryExpression<O, L1, R1> & lhs, const BinarryExpression<Division, L2, R2> & rhs)
+	template <char id, size_t degree, typename V>
+	struct Writer<Polynomial<id, degree, V> >
+	{
+		template <class Format, class Sink>
+		static inline void Write(const Polynomial<id, degree, V> & expr, Sink & sink)
 		{
-			return
-			{
-				{
-					lhs.m_leftOperand * rhs.m_rightOperand,
-					lhs.m_rightOperand * rhs.m_rightOperand
-				},
-				rhs.m_rightOperand
-			};
+			auto horner = HornerExpansion<0, degree>::Get(expr.m_coefficients, Variable<id>());
+			Writer<decltype(horner)>::template Write<Format>(horner, sink);
 		}
 	};
-	template <typename T1, typename T>
-	struct SimplifierBase<Expression<T1>, T>
+
+	template <char id, size_t degree, typename V>
+	struct NodeBuilder<Polynomial<id, degree, V> >
 	{
-		typedef typename SimplifierBase<T1, T>::type type;
-		static inline type Simplify(const Expression<T1> & lhs, const T & rhs)
+		static inline const Node * Build(const Polynomial<id, degree, V> & expr, Arena & arena)
 		{
-			return SimplifierBase<T1, T>::Simplify(lhs(), rhs);
+			const Node * variable = NodeFactory::Variable(arena, id);
+			const Node * result = NodeFactory::Value(arena, (long double)expr.m_coefficients[degree]);
+			for (size_t k = degree; k-- > 0;)
+			{
+				result = NodeFactory::Binary(
+					arena,
+					NodeKind::Addition,
+					NodeFactory::Binary(arena, NodeKind::Multiplication, result, variable),
+					NodeFactory::Value(arena, (long double)expr.m_coefficients[k])
+				);
+			}
+			return result;
 		}
 	};
 
-	template <typename T1, typename T, bool first>
-	struct Simplifier
+	template <char id, typename V, class T, bool convert = (PolynomialDegree<id, T>::value > 0)>
+	struct Polynomializer
 	{
-		typedef typename SimplifierBase<T1, T>::type type;
-		static inline type Simplify(const T1 & lhs, const T & rhs)
+		typedef Polynomial<id, (size_t)PolynomialDegree<id, T>::value, V> type;
+		static inline type Get(const T & expr)
 		{
-			return SimplifierBase<T1, T>::Simplify(lhs, rhs);
+			return{ PolynomialCoefficients<id, V, T>::Get(expr) };
 		}
 	};
-	template <typename T1, typename T>
-	struct Simplifier<T1, T, true>
+	template <char id, typename V, class T>
+	struct Polynomializer<id, V, Expression<T>, false> : Polynomializer<id, V, T>
 	{
-		typedef T1 type;
-		static inline type Simplify(const T1 & expr, const T &)
+	};
+	template <char id, typename V, class T>
+	struct Polynomializer<id, V, Expression<T>, true> : Polynomializer<id, V, T>
+	{
+	};
+	template <char id, typename V, class T>
+	struct Polynomializer<id, V, T, false>
+	{
+		static inline T Get(const T & expr)
 		{
 			return expr;
 		}
 	};
-	template <typename T1, typename T>
-	struct Simplifier<Expression<T1>, T, true>
+	template <char id, typename V>
+	struct Polynomializer<id, V, Variable<id>, true>
 	{
-		typedef T1 type;
-		static inline type Simplify(const Expression<T1> & expr, const T &)
+		static inline Variable<id> Get(const Variable<id> & expr)
 		{
-			return expr();
+			return expr;
 		}
 	};
-
-	template <class T>
-	static inline auto simplify(const T & expr)
+	template <char id, typename V, class Operator, class Operand>
+	struct Polynomializer<id, V, UnaryExpression<Operator, Operand>, false>
 	{
-		return Simplifier<T, typename FirstDivision<T>::type, FirstDivision<T>::value>::Simplify(expr, FirstDivision<T>::Get(expr));
-	}
-
-	template <char id, typename toT, class T, bool div>
-	struct Limit
-	{
-		static inline long double Get(const LimitParam<id, toT> & param, const Expression<T> & expr)
+		static inline auto Get(const UnaryExpression<Operator, Operand> & expr)
 		{
-			auto var = Variable<id>();
-			auto binded = bind(expr, var, param.m_to);
-			return binded();
+			auto operand = Polynomializer<id, V, Operand>::Get(expr.m_operand);
+			return UnaryExpression<Operator, decltype(operand)>(std::move(operand));
 		}
 	};
-	template <char id, typename toT, class T>
-	struct Limit<id, toT, T, true>
+	template <char id, typename V, class Operator, class Operand>
+	struct Polynomializer<id, V, PostfixExpression<Operator, Operand>, false>
 	{
-		static inline long double Get(const LimitParam<id, toT> & param, const Expression<T> & expr)
+		static inline auto Get(const PostfixExpression<Operator, Operand> & expr)
 		{
-			auto var = Variable<id>();
-
-			long double result = 0;
-
-			auto derive1 = simplify(expr);
-			auto bind1 = bind(derive1, var, param.m_to);
-			result = bind1();
-			if (!(result != result)) return result;
-
-			auto derive2 = lopital(derive1);
-			auto bind2 = bind(derive2, var, param.m_to);
-			result = bind2();
-			if (!(result != result)) return result;
-
-			auto derive3 = lopital(derive2);
-			auto bind3 = bind(derive3, var, param.m_to);
-			result = bind3();
-			if (!(result != result)) return result;
-
-			auto derive4 = lopital(derive3);
-			auto bind4 = bind(derive4, var, param.m_to);
-			result = bind4();
-			if (!(result != result)) return result;
-
-			auto derive5 = lopital(derive4);
-			auto bind5 = bind(derive5, var, param.m_to);
-			result = bind5();
-			if (!(result != result)) return result;
-
-			return result;
+			auto operand = Polynomializer<id, V, Operand>::Get(expr.m_operand);
+			return PostfixExpression<Operator, decltype(operand)>(std::move(operand));
 		}
 	};
-
-	template<char id, typename toT, class T>
-	static inline long double lim(const LimitParam<id, toT> && param, const Expression<T> & expr)
-	{
-		return Limit<id, toT, T, HasDivision<T>::value>::Get(param, expr);
-	}
-
-	template <class T>
-	static inline UnaryExpression<UnaryMinus, T> operator-(const Expression<T>& value)
-	{
-		return UnaryExpression<UnaryMinus, T>(value());
-	}
-
-	template <class T>
-	static inline UnaryExpression<UnaryAddition, T> operator++(const Expression<T>& value)
+	template <char id, typename V, class F, class T>
+	struct Polynomializer<id, V, FunctionExpression<F, T>, false>
 	{
-		return{ value() };
-	}
-
-	template <class T>
-	static inline UnaryExpression<UnarySubtraction, T> operator--(const Expression<T>& value)
+		static inline auto Get(const FunctionExpression<F, T> & expr)
+		{
+			auto operand = Polynomializer<id, V, T>::Get(expr.m_operand);
+			return FunctionExpression<F, decltype(operand)>(std::move(operand));
+		}
+	};
+	template <char id, typename V, class Operator, class LeftOperand, class RightOperand>
+	struct Polynomializer<id, V, BinarryExpression<Operator, LeftOperand, RightOperand>, false>
 	{
-		return{ value() };
-	}
-
-	template <class Lhs, class Rhs>
-	static inline BinarryExpression<Addition, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type> operator+(const Lhs& d1, const Rhs& d2)
+		static inline auto Get(const BinarryExpression<Operator, LeftOperand, RightOperand> & expr)
+		{
+			auto lhs = Polynomializer<id, V, LeftOperand>::Get(expr.m_leftOperand);
+			auto rhs = Polynomializer<id, V, RightOperand>::Get(expr.m_rightOperand);
+			return BinarryExpression<Operator, decltype(lhs), decltype(rhs)>(std::move(lhs), std::move(rhs));
+		}
+	};
+	template <char id, typename V, class... Ts>
+	struct Polynomializer<id, V, Sum<Ts...>, false>
 	{
-		return{ ExpressionOperator<Lhs>::GetParam(d1), ExpressionOperator<Rhs>::GetParam(d2) };
-	}
+		static inline auto Get(const Sum<Ts...> & expr)
+		{
+			return Get(expr.m_operands, std::index_sequence_for<Ts...>());
+		}
 
-	template <class Lhs, class Rhs>
-	static inline BinarryExpression<Subtraction, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type> operator-(const Lhs& d1, const Rhs& d2)
+		template <size_t... i>
+		static inline auto Get(const std::tuple<Ts...> & operands, std::index_sequence<i...>)
+		{
+			return Sum<decltype(Polynomializer<id, V, Ts>::Get(std::get<i>(operands)))...>(Polynomializer<id, V, Ts>::Get(std::get<i>(operands))...);
+		}
+	};
+	template <char id, typename V, class... Ts>
+	struct Polynomializer<id, V, Product<Ts...>, false>
 	{
-		return{ ExpressionOperator<Lhs>::GetParam(d1), ExpressionOperator<Rhs>::GetParam(d2) };
-	}
+		static inline auto Get(const Product<Ts...> & expr)
+		{
+			return Get(expr.m_operands, std::index_sequence_for<Ts...>());
+		}
 
-	template <class Lhs, class Rhs>
-	static inline BinarryExpression<Multiplication, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type> operator*(const Lhs& d1, const Rhs& d2)
-	{
-		return{ ExpressionOperator<Lhs>::GetParam(d1), ExpressionOperator<Rhs>::GetParam(d2) };
-	}
+		template <size_t... i>
+		static inline auto Get(const std::tuple<Ts...> & operands, std::index_sequence<i...>)
+		{
+			return Product<decltype(Polynomializer<id, V, Ts>::Get(std::get<i>(operands)))...>(Polynomializer<id, V, Ts>::Get(std::get<i>(operands))...);
+		}
+	};
 
-	template <class Lhs, class Rhs>
-	static inline BinarryExpression<Division, typename ExpressionOperator<Lhs>::type, typename ExpressionOperator<Rhs>::type> operator/(const Lhs& d1, const Rhs& d2)
+	template <typename V = long double, char id, class T>
+	static inline auto polynomial(const Variable<id> &, const Expression<T> & expr)
 	{
-		return{ ExpressionOperator<Lhs>::GetParam(d1), ExpressionOperator<Rhs>::GetParam(d2) };
+		return Polynomializer<id, V, T>::Get(expr());
 	}
 }
 